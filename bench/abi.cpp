@@ -0,0 +1,414 @@
+// SPDX-License-Identifier: MIT
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+
+#include "core/algorithm.h"
+#include "core/dispatch.h"
+#include "core/divisor.h"
+#include "core/types.h"
+
+#include "bench.h"
+
+//------------------------------------------------------------------------------
+// abi<> and data<> microbenchmarks, compiled once per instruction set.
+//
+// Throughput runs keep several independent operations in flight; latency runs
+// feed each result into the next operation. Memory ops stream over buffers
+// that stay within the first two cache levels.
+//------------------------------------------------------------------------------
+namespace {
+
+using namespace comp::core;
+namespace bench = comp::bench;
+
+//! independent operations in flight during throughput runs
+constexpr int chains = 8;
+
+//! size of the byte and unit buffers, a power of two
+constexpr std::size_t buffer_size = 64 * 1024;
+//! number of units in the gather/scatter table
+constexpr std::size_t table_size = 4096;
+//! number of precomputed index vectors and masks
+constexpr std::size_t pattern_size = 256;
+
+//! Raw cache line aligned storage with internal linkage.
+class buffer {
+  private:
+    void *p_;
+
+  public:
+    explicit buffer(std::size_t const &n) : p_(std::aligned_alloc(64, n)) { }
+    buffer(buffer const &) = delete;
+    auto operator=(buffer const &) -> buffer& = delete;
+    ~buffer() { std::free(p_); }
+
+    template <class T>
+    auto as() const -> T* { return static_cast<T*>(p_); }
+};
+
+template <class dataT>
+class suite {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+
+    char const *type_;
+    double      min_ns_;
+
+    buffer bytes_;
+    buffer units_;
+    buffer table_;
+    buffer index_;
+    buffer masks_;
+
+    auto report(char const *op, char const *mode, bench::timing const &t,
+                double const &ops, double const &bytes) -> void {
+      bench::emit({ isa_name(this_isa), type_, op, mode,
+                    t.ns / ops, t.cycles / ops, t.cycles / (ops * arity), bytes / t.ns });
+    }
+
+    auto seed(int const &j) const -> baseT {
+      return abi::set(static_cast<unitT>(0x9e3779b97f4a7c15ull * (j + 1)));
+    }
+
+    //! Register-to-register op, f(baseT) -> baseT or maskT.
+    template <class fnT>
+    auto compute(char const *op, fnT const &f) -> void {
+      baseT x[chains];
+      for (int j = 0; j < chains; j++)
+        x[j] = seed(j);
+
+      auto const tp = bench::measure(min_ns_, [&](std::size_t const &iters) {
+        for (std::size_t i = 0; i < iters; i++) {
+          for (int j = 0; j < chains; j++) {
+            bench::escape(x[j]);
+            auto r = f(x[j]);
+            bench::escape(r);
+          }
+        }
+      });
+      report(op, "throughput", tp, chains, chains * arity * sizeof(unitT));
+
+      if constexpr (sizeof(decltype(f(x[0]))) == sizeof(baseT)) {
+        auto y = x[0];
+        auto const lt = bench::measure(min_ns_, [&](std::size_t const &iters) {
+          for (std::size_t i = 0; i < iters; i++) {
+            y = f(y);
+            bench::escape(y);
+          }
+        });
+        report(op, "latency", lt, 1, arity * sizeof(unitT));
+      }
+    }
+
+    //! Op driven by the iteration number, moving bytes bytes per call.
+    template <class fnT>
+    auto memory(char const *op, double const &bytes, fnT const &f) -> void {
+      auto const tp = bench::measure(min_ns_, [&](std::size_t const &iters) {
+        for (std::size_t i = 0; i < iters; i++)
+          f(i);
+        bench::clobber();
+      });
+      report(op, "throughput", tp, 1, bytes);
+    }
+
+    auto mask(std::size_t const &i) const -> maskT {
+      return masks_.as<maskT>()[i % pattern_size];
+    }
+    auto index(std::size_t const &i) const -> baseT {
+      return abi::lod(index_.as<unitT>() + (i % pattern_size) * arity);
+    }
+
+  public:
+    // Ctors
+    suite(char const *type, double const &min_ns)
+      : type_(type), min_ns_(min_ns),
+        bytes_(buffer_size + 64), units_(buffer_size + 64),
+        table_(table_size * sizeof(unitT)), index_(pattern_size * arity * sizeof(unitT)),
+        masks_(pattern_size * sizeof(maskT))
+    {
+      std::mt19937_64 g(1);
+      for (std::size_t i = 0; i < buffer_size + 64; i++)
+        bytes_.as<unsigned char>()[i] = static_cast<unsigned char>(g());
+      for (std::size_t i = 0; i < (buffer_size + 64) / sizeof(unitT); i++)
+        units_.as<unitT>()[i] = static_cast<unitT>(g());
+      for (std::size_t i = 0; i < table_size; i++)
+        table_.as<unitT>()[i] = static_cast<unitT>(g());
+      for (std::size_t i = 0; i < pattern_size * arity; i++)
+        index_.as<unitT>()[i] = static_cast<unitT>(g() % table_size);
+      for (std::size_t i = 0; i < pattern_size; i++)
+        masks_.as<maskT>()[i] = static_cast<maskT>(g() & data_traits<dataT>::mask_max);
+    }
+
+    auto run_abi() -> void;
+    auto run_data() -> void;
+};
+
+template <class dataT>
+auto suite<dataT>::run_abi() -> void {
+  auto *const b = bytes_.as<unsigned char>();
+  auto *const u = units_.as<unitT>();
+  auto *const t = table_.as<unitT>();
+
+  constexpr auto bmask = buffer_size - 1;
+  constexpr auto umask = buffer_size / sizeof(unitT) - 1;
+
+  double avg = 0;
+  for (std::size_t i = 0; i < pattern_size; i++)
+    avg += abi::mcnt(mask(i));
+  avg /= pattern_size;
+
+  //----------------------------------------------------------------------------
+  // data movement
+  //----------------------------------------------------------------------------
+  memory("abi::set", arity * sizeof(unitT), [&](std::size_t const &i) {
+    auto r = abi::set(static_cast<unitT>(i));
+    bench::escape(r);
+  });
+  memory("abi::get", arity, [&](std::size_t const &i) {
+    auto r = abi::get(b + ((i * arity) & bmask));
+    bench::escape(r);
+  });
+  memory("abi::put", arity, [&](std::size_t const &i) {
+    abi::put(b + ((i * arity) & bmask), seed(0));
+  });
+  memory("abi::lod", arity * sizeof(unitT), [&](std::size_t const &i) {
+    auto r = abi::lod(u + ((i * arity) & umask));
+    bench::escape(r);
+  });
+  memory("abi::cpy", arity * sizeof(unitT), [&](std::size_t const &i) {
+    abi::cpy(u + ((i * arity) & umask), seed(0));
+  });
+  memory("abi::mlod", avg * sizeof(unitT), [&](std::size_t const &i) {
+    auto r = abi::mlod(mask(i), u + ((i * arity) & umask));
+    bench::escape(r);
+  });
+  memory("abi::mcpy", avg * sizeof(unitT), [&](std::size_t const &i) {
+    abi::mcpy(u + ((i * arity) & umask), mask(i), seed(0));
+  });
+
+  std::size_t pos = 0;
+  memory("abi::mget", avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    auto r = abi::mget(k, b + pos);
+    bench::escape(r);
+    pos = (pos + abi::mcnt(k)) & bmask;
+  });
+  pos = 0;
+  memory("abi::mput", avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    abi::mput(b + pos, k, seed(0));
+    pos = (pos + abi::mcnt(k)) & bmask;
+  });
+
+  memory("abi::get16", 2 * arity, [&](std::size_t const &i) {
+    auto r = abi::get16(b + ((i * 2 * arity) & bmask));
+    bench::escape(r);
+  });
+  memory("abi::put16", 2 * arity, [&](std::size_t const &i) {
+    abi::put16(b + ((i * 2 * arity) & bmask), seed(0));
+  });
+  memory("abi::get32", 4 * arity, [&](std::size_t const &i) {
+    auto r = abi::get32(b + ((i * 4 * arity) & bmask));
+    bench::escape(r);
+  });
+  memory("abi::put32", 4 * arity, [&](std::size_t const &i) {
+    abi::put32(b + ((i * 4 * arity) & bmask), seed(0));
+  });
+
+  pos = 0;
+  memory("abi::mget16", 2 * avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    auto r = abi::mget16(k, b + pos);
+    bench::escape(r);
+    pos = (pos + 2 * abi::mcnt(k)) & bmask;
+  });
+  pos = 0;
+  memory("abi::mput16", 2 * avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    abi::mput16(b + pos, k, seed(0));
+    pos = (pos + 2 * abi::mcnt(k)) & bmask;
+  });
+  pos = 0;
+  memory("abi::mget32", 4 * avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    auto r = abi::mget32(k, b + pos);
+    bench::escape(r);
+    pos = (pos + 4 * abi::mcnt(k)) & bmask;
+  });
+  pos = 0;
+  memory("abi::mput32", 4 * avg, [&](std::size_t const &i) {
+    auto const k = mask(i);
+    abi::mput32(b + pos, k, seed(0));
+    pos = (pos + 4 * abi::mcnt(k)) & bmask;
+  });
+
+  memory("abi::gather", arity * sizeof(unitT), [&](std::size_t const &i) {
+    auto r = abi::gather(index(i), t);
+    bench::escape(r);
+  });
+  memory("abi::scatter", arity * sizeof(unitT), [&](std::size_t const &i) {
+    abi::scatter(t, index(i), seed(0));
+  });
+  memory("abi::mgather", avg * sizeof(unitT), [&](std::size_t const &i) {
+    auto r = abi::mgather(mask(i), index(i), t);
+    bench::escape(r);
+  });
+  memory("abi::mscatter", avg * sizeof(unitT), [&](std::size_t const &i) {
+    abi::mscatter(t, mask(i), index(i), seed(0));
+  });
+
+  //----------------------------------------------------------------------------
+  // arithmetic
+  //----------------------------------------------------------------------------
+  auto const one   = abi::set(1);
+  auto const seven = abi::set(7);
+  divisor<dataT> const d(static_cast<unitT>(7));
+  auto const dm  = static_cast<baseT>(d.mul());
+  auto const ds1 = static_cast<baseT>(d.s1());
+  auto const ds2 = static_cast<baseT>(d.s2());
+  auto const k   = static_cast<maskT>(0x5555 & data_traits<dataT>::mask_max);
+
+  compute("abi::neg",   [&](baseT const &a) { return abi::neg(a); });
+  compute("abi::add",   [&](baseT const &a) { return abi::add(a, seven); });
+  compute("abi::sub",   [&](baseT const &a) { return abi::sub(a, seven); });
+  compute("abi::mul",   [&](baseT const &a) { return abi::mul(a, one); });
+  compute("abi::div",   [&](baseT const &a) { return abi::div(a, one); });
+  compute("abi::mulhi", [&](baseT const &a) { return abi::mulhi(a, seven); });
+  compute("abi::divr",  [&](baseT const &a) { return abi::divr(a, dm, ds1, ds2); });
+  compute("abi::muladd",   [&](baseT const &a) { return abi::muladd(a, one, seven); });
+  compute("abi::muladd52", [&](baseT const &a) { return abi::muladd52(a, one, seven); });
+  compute("abi::divmod",   [&](baseT const &a) { baseT r; auto q = abi::divmod(a, seven, r); return abi::add(q, r); });
+  compute("abi::madd",  [&](baseT const &a) { return abi::madd(k, a, seven); });
+  compute("abi::msub",  [&](baseT const &a) { return abi::msub(k, a, seven); });
+  compute("abi::mmul",  [&](baseT const &a) { return abi::mmul(k, a, one); });
+  compute("abi::mdiv",  [&](baseT const &a) { return abi::mdiv(k, a, one); });
+
+  //----------------------------------------------------------------------------
+  // bitwise
+  //----------------------------------------------------------------------------
+  compute("abi::bsl",  [&](baseT const &a) { return abi::bsl(a, 1); });
+  compute("abi::bsr",  [&](baseT const &a) { return abi::bsr(a, 1); });
+  compute("abi::bsrv", [&](baseT const &a) { return abi::bsrv(a, one); });
+  compute("abi::bsrm", [&](baseT const &a) { return abi::bsrm(a, 1, seven); });
+  compute("abi::mbsl", [&](baseT const &a) { return abi::mbsl(k, a, 1); });
+  compute("abi::mbsr", [&](baseT const &a) { return abi::mbsr(k, a, 1); });
+  compute("abi::land", [&](baseT const &a) { return abi::land(a, seven); });
+  compute("abi::lor",  [&](baseT const &a) { return abi::lor(a, seven); });
+  compute("abi::eor",  [&](baseT const &a) { return abi::eor(a, seven); });
+  compute("abi::mlor", [&](baseT const &a) { return abi::mlor(k, a, seven); });
+  compute("abi::meor", [&](baseT const &a) { return abi::meor(k, a, seven); });
+
+  //----------------------------------------------------------------------------
+  // horizontal
+  //----------------------------------------------------------------------------
+  // lane i takes lane arity - 1 - i.
+  auto const rev = abi::sub(abi::set(arity), abi::iscan(one));
+
+  compute("abi::hadd",  [&](baseT const &a) { return abi::hadd(a); });
+  compute("abi::hmin",  [&](baseT const &a) { return abi::hmin(a); });
+  compute("abi::hmax",  [&](baseT const &a) { return abi::hmax(a); });
+  compute("abi::hlor",  [&](baseT const &a) { return abi::hlor(a); });
+  compute("abi::heor",  [&](baseT const &a) { return abi::heor(a); });
+  compute("abi::iscan", [&](baseT const &a) { return abi::iscan(a); });
+  compute("abi::escan", [&](baseT const &a) { return abi::escan(a); });
+  compute("abi::perm",  [&](baseT const &a) { return abi::perm(a, rev); });
+  compute("abi::bcst",  [&](baseT const &a) { return abi::bcst(a, arity - 1); });
+
+  //----------------------------------------------------------------------------
+  // masks
+  //----------------------------------------------------------------------------
+  memory("abi::mcnt", 0, [&](std::size_t const &i) {
+    auto r = abi::mcnt(mask(i));
+    bench::escape(r);
+  });
+
+  compute("abi::cmpgt", [&](baseT const &a) { return abi::cmpgt(a, seven); });
+  compute("abi::cmple", [&](baseT const &a) { return abi::cmple(a, seven); });
+  compute("abi::cmpeq", [&](baseT const &a) { return abi::cmpeq(a, seven); });
+  compute("abi::cmpne", [&](baseT const &a) { return abi::cmpne(a, seven); });
+
+#if defined(__AVX512CD__)
+  if constexpr (1 < arity)
+    compute("abi::cnfl", [&](baseT const &a) { return abi::cnfl(abi::land(a, seven)); });
+#endif
+}
+
+template <class dataT>
+auto suite<dataT>::run_data() -> void {
+  auto const one   = dataT(static_cast<unitT>(1));
+  auto const seven = dataT(static_cast<unitT>(7));
+  divisor<dataT> const d(static_cast<unitT>(7));
+  auto const k = static_cast<maskT>(0x5555 & data_traits<dataT>::mask_max);
+
+  auto const base = [](dataT const &a) { return static_cast<baseT>(a); };
+
+  compute("data::operator-(a)",     [&](baseT const &a) { return base(-dataT(a)); });
+  compute("data::operator+",        [&](baseT const &a) { return base(dataT(a) + seven); });
+  compute("data::operator+(unit)",  [&](baseT const &a) { return base(dataT(a) + static_cast<unitT>(7)); });
+  compute("data::operator-",        [&](baseT const &a) { return base(dataT(a) - seven); });
+  compute("data::operator*",        [&](baseT const &a) { return base(dataT(a) * one); });
+  compute("data::operator/",        [&](baseT const &a) { return base(dataT(a) / one); });
+  compute("data::operator/(divisor)", [&](baseT const &a) { return base(dataT(a) / d); });
+  compute("data::operator^",        [&](baseT const &a) { return base(dataT(a) ^ seven); });
+  compute("data::operator>>",       [&](baseT const &a) { return base(dataT(a) >> 1); });
+  compute("data::muladd",           [&](baseT const &a) { return base(muladd(dataT(a), one, seven)); });
+  compute("data::muladd52",         [&](baseT const &a) { return base(muladd52(dataT(a), one, seven)); });
+  compute("data::divmod",           [&](baseT const &a) { auto r = divmod(dataT(a), seven); return base(r.quot + r.rem); });
+  compute("data::bsrm",             [&](baseT const &a) { return base(bsrm(dataT(a), 1, seven)); });
+  compute("data::reduce_add",       [&](baseT const &a) { return reduce_add(dataT(a)); });
+  compute("data::inclusive_scan",   [&](baseT const &a) { return base(inclusive_scan(dataT(a))); });
+  compute("data::broadcast",        [&](baseT const &a) { return base(broadcast(dataT(a), arity - 1)); });
+
+  compute("data::operator+=", [&](baseT const &a) { dataT v(a); v += seven; return base(v); });
+  compute("data::operator*=", [&](baseT const &a) { dataT v(a); v *= one; return base(v); });
+  compute("data::operator/=", [&](baseT const &a) { dataT v(a); v /= one; return base(v); });
+  compute("data::operator|=", [&](baseT const &a) { dataT v(a); v |= seven; return base(v); });
+  compute("data::operator>>=", [&](baseT const &a) { dataT v(a); v >>= 1; return base(v); });
+  compute("data::operator<<=", [&](baseT const &a) { dataT v(a); v <<= 1; return base(v); });
+  compute("data::operator[]<<=", [&](baseT const &a) { dataT v(a); v[k] <<= 1; return base(v); });
+  compute("where<<=", [&](baseT const &a) { dataT v(a); where(k, v) <<= 1; return base(v); });
+  compute("where>>=", [&](baseT const &a) { dataT v(a); where(k, v) >>= 1; return base(v); });
+  compute("where+=",  [&](baseT const &a) { dataT v(a); where(k, v) += seven; return base(v); });
+  compute("where-=",  [&](baseT const &a) { dataT v(a); where(k, v) -= seven; return base(v); });
+  compute("where*=",  [&](baseT const &a) { dataT v(a); where(k, v) *= one; return base(v); });
+  compute("where/=",  [&](baseT const &a) { dataT v(a); where(k, v) /= one; return base(v); });
+  compute("where|=",  [&](baseT const &a) { dataT v(a); where(k, v) |= seven; return base(v); });
+  compute("where^=",  [&](baseT const &a) { dataT v(a); where(k, v) ^= seven; return base(v); });
+  compute("where--",  [&](baseT const &a) { dataT v(a); where(k, v)--; return base(v); });
+  compute("data::operator--", [&](baseT const &a) { dataT v(a); v--; return base(v); });
+
+  compute("data::operator>",       [&](baseT const &a) { return dataT(a) > seven; });
+  compute("data::operator<=(unit)", [&](baseT const &a) { return dataT(a) <= static_cast<unitT>(7); });
+  compute("data::operator==",      [&](baseT const &a) { return dataT(a) == seven; });
+  compute("data::operator!=",      [&](baseT const &a) { return dataT(a) != seven; });
+}
+
+template <class dataT>
+auto run(char const *type, double const &min_ns) -> void {
+  suite<dataT> s(type, min_ns);
+  s.run_abi();
+  s.run_data();
+}
+
+auto bench_abi(double min_ns) -> void {
+  run<scalar>("scalar", min_ns);
+#if defined(__AVX512F__) || defined(__AVX2__)
+  run<simd<4>>("simd<4>", min_ns);
+#endif
+#if defined(__AVX512F__)
+  run<simd<8>>("simd<8>", min_ns);
+  run<simd<16>>("simd<16>", min_ns);
+#endif
+}
+
+} // namespace
+
+COMP_DISPATCH_DEFINE(bench_abi, &bench_abi)
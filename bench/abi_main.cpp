@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: MIT
+#include <array>
+#include <cstdio>
+
+#include "core/dispatch.h"
+
+#include "bench.h"
+
+//------------------------------------------------------------------------------
+// comp-bench-abi -- per-op throughput and latency of every instruction set the
+// host supports, as json.
+//------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  comp::bench::options opt{ 20e6, nullptr, 0 };
+  if (!comp::bench::parse_args(argc, argv, opt))
+    return 1;
+
+  std::array<comp_dispatch_bench_abi::type*, comp::core::isa_count> const variants{{
+    comp_dispatch_bench_abi::scalar,
+    comp_dispatch_bench_abi::avx2,
+    comp_dispatch_bench_abi::avx512f,
+    comp_dispatch_bench_abi::avx512dqvl,
+    comp_dispatch_bench_abi::avx512vbmi2
+  }};
+
+  auto const host = static_cast<int>(comp::core::host_isa());
+  for (int i = 0; i <= host; i++) {
+    // an emulated build has only the variant of its march
+    if (!variants[i])
+      continue;
+    std::fprintf(stderr, "comp-bench-abi: %s\n", comp::core::isa_name(static_cast<comp::core::isa>(i)));
+    variants[i](opt.min_ns);
+  }
+
+  return comp::bench::write_json("abi", opt.path) ? 0 : 1;
+}
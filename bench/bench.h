@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_BENCH_BENCH_H
+#define COMP_BENCH_BENCH_H 1
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/dispatch.h"
+
+//------------------------------------------------------------------------------
+// results, collected by report.cpp and written as json.
+//
+// Kernels are compiled once per instruction set, so this interface is kept to
+// plain structs and out-of-line functions; nothing with external linkage may
+// be instantiated in a kernel with wider instructions than the host has.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace bench {
+
+//! One measurement of an abi<> op or data<> operator.
+struct op_sample {
+  char const *isa;
+  char const *type;
+  char const *op;
+  char const *mode;
+  double      ns_per_op;
+  double      cycles_per_op;
+  double      cycles_per_elem;
+  double      gb_per_s;
+};
+
+//! One encode/decode run of the full codec over a corpus.
+struct codec_sample {
+  char const *isa;
+  char const *type;
+  char const *corpus;
+  std::size_t block_size;
+  std::size_t threads;
+  //! "static", coded with a stored table, "order1", with a stored order-1
+  //! table, "adaptive", "container", coded with stored tables into a
+  //! seekable container, "file", the same container from and to files
+  //! through memory maps, or "pipeline", streamed to a file, which is only
+  //! timed compressing
+  char const *model;
+  std::size_t input_bytes;
+  std::size_t encoded_bytes;
+  double      ratio;
+  double      encode_mb_per_s;
+  double      decode_mb_per_s;
+  std::size_t peak_bytes;
+};
+
+//! Corpus handed to the codec kernel.
+struct codec_job {
+  char const          *corpus;
+  std::uint8_t const  *data;
+  std::size_t          size;
+  std::size_t          block_size;
+  double               min_ns;
+};
+
+auto emit(op_sample const &s) -> void;
+auto emit(codec_sample const &s) -> void;
+
+//! Start tracking the peak heap usage above the current usage.
+auto reset_peak() -> void;
+//! Peak heap usage since reset_peak(), in bytes.
+auto peak_bytes() -> std::size_t;
+
+//! Write everything emitted so far to path, or stdout if path is null.
+auto write_json(char const *benchmark, char const *path) -> bool;
+
+//! Command line of the benchmark executables.
+struct options {
+  //! minimum run time of a measurement, --min-time <ms>
+  double      min_ns;
+  //! json output, --out <file>, or stdout
+  char const *path;
+  //! bytes per generated corpus, --size <MiB>
+  std::size_t size;
+};
+
+auto parse_args(int argc, char **argv, options &opt) -> bool;
+
+} // namespace bench
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// kernels, one variant per instruction set.
+//------------------------------------------------------------------------------
+//! every abi<> op and data<> operator of every type, given the minimum run
+//! time of a measurement in ns
+COMP_DISPATCH_DECLARE(bench_abi, void(double))
+//! histogram, normalize, encode and decode a corpus block by block, with
+//! every type, on one thread and on a pool of every hardware thread, large
+//! blocks with the order-1 coder, and small blocks as messages of the adaptive
+//! coder
+COMP_DISPATCH_DECLARE(bench_codec, void(comp::bench::codec_job const *))
+
+//------------------------------------------------------------------------------
+// measurement helpers, internal to each kernel.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace bench {
+namespace {
+
+//! Time stamp counter, in reference cycles.
+inline auto ticks() -> std::uint64_t {
+#if defined(__x86_64__) || defined(__i386__)
+  // the builtin, since the intrinsic headers clash with the emulator's types.
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+
+//! Make v opaque to the optimizer without moving it out of its register.
+template <class T>
+inline auto escape(T &v) -> void {
+  if constexpr (std::is_integral<T>::value) {
+#if defined(__AVX512F__) && !defined(COMP_EMU_MARCH)
+    if constexpr (sizeof(T) <= 2)
+      __asm__ volatile ("" : "+rk"(v));
+    else
+      __asm__ volatile ("" : "+r"(v));
+#else
+    __asm__ volatile ("" : "+r"(v));
+#endif
+  } else {
+#if defined(COMP_EMU_MARCH)
+    // emulated vectors are plain unions, which live in memory.
+    __asm__ volatile ("" : "+m"(v));
+#else
+    __asm__ volatile ("" : "+v"(v));
+#endif
+  }
+}
+
+//! Force every pending store to memory.
+inline auto clobber() -> void {
+  __asm__ volatile ("" : : : "memory");
+}
+
+struct timing {
+  double ns;
+  double cycles;
+};
+
+//! Time f(iters), doubling iters from first until a run lasts at least
+//! min_ns, and return the cost of a single iteration.
+template <class fnT>
+inline auto measure(double const &min_ns, fnT const &f, std::size_t const &first = 16) -> timing {
+  using clock = std::chrono::steady_clock;
+
+  f(first);
+
+  for (std::size_t iters = first;; iters *= 2) {
+    auto const t0 = clock::now();
+    auto const c0 = ticks();
+    f(iters);
+    auto const c1 = ticks();
+    auto const t1 = clock::now();
+
+    double const ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    if (ns >= min_ns)
+      return { ns / iters, static_cast<double>(c1 - c0) / iters };
+  }
+}
+
+} // namespace
+} // namespace bench
+} // namespace comp
+
+#endif // COMP_BENCH_BENCH_H
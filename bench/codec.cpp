@@ -0,0 +1,560 @@
+// SPDX-License-Identifier: MIT
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <unistd.h>
+
+#include "core/adaptive.h"
+#include "core/container.h"
+#include "core/dispatch.h"
+#include "core/histogram.h"
+#include "core/internal/vector.h"
+#include "core/mmap.h"
+#include "core/order1.h"
+#include "core/parallel.h"
+#include "core/pipeline.h"
+#include "core/rans.h"
+#include "core/thread_pool.h"
+#include "core/types.h"
+
+#include "bench.h"
+
+//------------------------------------------------------------------------------
+// end-to-end codec benchmark, compiled once per instruction set.
+//
+// Every block of the corpus is coded on its own: histogram, normalize, build
+// the coder, encode. Decoding rebuilds the coder from the stored frequencies,
+// as a reader of the stream would, and checks the result. The compression
+// ratio charges each block for its frequency table. The same blocks are then
+// coded by parallel_rans on a pool of every hardware thread, whose ratio is
+// that of its actual output, and written to a seekable container on the same
+// pool, which is read back whole and by point queries across block
+// boundaries, and once more from file to file, through memory maps and
+// through the streaming pipeline, over an output file longer than the
+// container so that it must be cut down. Large blocks are coded by order1_rans as well, charged for their
+// stored tables, and small blocks as messages on their own by adaptive_rans,
+// which stores no table at all.
+//------------------------------------------------------------------------------
+namespace {
+
+using namespace comp::core;
+namespace bench = comp::bench;
+
+//! precision of the frequency tables, supported by every type
+constexpr int bits = 12;
+//! bytes charged per block for its frequency table
+constexpr std::size_t header_size = table_size;
+//! smallest block size the order-1 coder is run at, as its tables are large
+constexpr std::size_t order1_min = 64u << 10;
+//! largest block size the adaptive coder is run at, as it is meant for short
+//! messages
+constexpr std::size_t adaptive_max = 4u << 10;
+//! point queries checked per container
+constexpr std::size_t queries = 64;
+
+//! Heap storage with internal linkage, counted by the peak memory tracking.
+class buffer {
+  private:
+    byte *p_;
+
+  public:
+    explicit buffer(std::size_t const &n) : p_(static_cast<byte*>(::operator new(n))) { }
+    buffer(buffer const &) = delete;
+    auto operator=(buffer const &) -> buffer& = delete;
+    ~buffer() { ::operator delete(p_); }
+
+    auto data() const -> byte* { return p_; }
+};
+
+//! A file of its own under $TMPDIR, or /tmp, removed along with it.
+class temp_file {
+  private:
+    char path_[4096];
+    int  fd_;
+
+  public:
+    temp_file() : fd_(-1) {
+      auto const *dir = std::getenv("TMPDIR");
+      auto const  n   = std::snprintf(path_, sizeof(path_), "%s/comp-bench-XXXXXX", dir && *dir ? dir : "/tmp");
+      if (n > 0 && static_cast<std::size_t>(n) < sizeof(path_))
+        fd_ = ::mkstemp(path_);
+    }
+    temp_file(temp_file const &) = delete;
+    auto operator=(temp_file const &) -> temp_file& = delete;
+    ~temp_file() {
+      if (fd_ < 0)
+        return;
+      ::close(fd_);
+      ::unlink(path_);
+    }
+
+    auto ok() const -> bool { return fd_ >= 0; }
+    auto fd() const -> int { return fd_; }
+    auto path() const -> char const* { return path_; }
+
+    //! Write all n bytes at p at the offset of the file.
+    auto write(byte const *p, std::size_t n) -> bool {
+      while (n > 0) {
+        auto const w = ::write(fd_, p, n);
+        if (w <= 0)
+          return false;
+        p += w;
+        n -= static_cast<std::size_t>(w);
+      }
+      return true;
+    }
+};
+
+template <class dataT>
+auto run(char const *type, bench::codec_job const &job) -> void {
+  using codec = rans<dataT>;
+
+  auto const block  = job.block_size;
+  auto const blocks = (job.size + block - 1) / block;
+
+  bench::reset_peak();
+
+  internal::vector<freq> f(blocks * codec::alphabet);
+  internal::vector<std::size_t> len(blocks);
+  buffer enc(blocks * codec::bound(block));
+  buffer dec(job.size);
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < blocks; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+
+        internal::vector<freq> h(codec::alphabet);
+        histogram<dataT>(job.data + at, n, h);
+        normalize(h, bits);
+        std::memcpy(&f[b * codec::alphabet], h.data(), codec::alphabet * sizeof(freq));
+
+        codec const c(h, bits);
+        len[b] = c.encode(job.data + at, n, enc.data() + b * codec::bound(block));
+      }
+      bench::clobber();
+    }
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < blocks; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+
+        internal::vector<freq> h(&f[b * codec::alphabet], &f[(b + 1) * codec::alphabet]);
+        codec const c(h, bits);
+        c.decode(enc.data() + b * codec::bound(block), len[b], n, dec.data() + at);
+      }
+      bench::clobber();
+    }
+  };
+
+  // one iteration is a pass over the whole corpus.
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  if (0 != std::memcmp(job.data, dec.data(), job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  std::size_t encoded = 0;
+  for (auto const &l : len)
+    encoded += l + header_size;
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, block, 1, "static", job.size, encoded,
+                static_cast<double>(job.size) / encoded,
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+template <class dataT>
+auto run_parallel(char const *type, bench::codec_job const &job, thread_pool &pool) -> void {
+  parallel_rans<dataT> const codec(pool, job.block_size, bits);
+
+  bench::reset_peak();
+
+  buffer enc(codec.bound(job.size));
+  buffer dec(job.size);
+  std::size_t encoded = 0;
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      encoded = codec.encode(job.data, job.size, enc.data());
+      bench::clobber();
+    }
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      codec.decode(enc.data(), encoded, dec.data());
+      bench::clobber();
+    }
+  };
+
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  if (0 != std::memcmp(job.data, dec.data(), job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: parallel round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, job.block_size, pool.size(), "static", job.size, encoded,
+                static_cast<double>(job.size) / encoded,
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+template <class dataT>
+auto run_container(char const *type, bench::codec_job const &job, thread_pool &pool) -> void {
+  container_writer<dataT> const w(pool, job.block_size, bits);
+
+  bench::reset_peak();
+
+  buffer enc(w.bound(job.size));
+  buffer dec(job.size);
+  std::size_t encoded = 0;
+  bool        ok      = true;
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      encoded = w.encode(job.data, job.size, enc.data());
+      bench::clobber();
+    }
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      container_reader<dataT> const r(enc.data(), encoded);
+      ok = r.ok() && r.decode(pool, 0, job.size, dec.data()) && ok;
+      bench::clobber();
+    }
+  };
+
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  // ranges of up to two blocks from spread out starts, so most of them
+  // straddle a block boundary, decoded serially and on the pool.
+  container_reader<dataT> const r(enc.data(), encoded);
+  buffer part(2 * job.block_size);
+  for (std::size_t q = 0; ok && q < queries; q++) {
+    auto const pos = q * (job.size / queries) + q % job.block_size;
+    if (pos >= job.size)
+      break;
+    auto const len = 1 + (q * 2654435761u) % (2 * job.block_size);
+    auto const m   = len < job.size - pos ? len : job.size - pos;
+    ok = r.decode(pos, m, part.data()) && 0 == std::memcmp(job.data + pos, part.data(), m)
+      && r.decode(pool, pos, m, part.data()) && 0 == std::memcmp(job.data + pos, part.data(), m);
+  }
+
+  if (!ok || 0 != std::memcmp(job.data, dec.data(), job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: container round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, job.block_size, pool.size(), "container", job.size, encoded,
+                static_cast<double>(job.size) / encoded,
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+template <class dataT>
+auto run_file(char const *type, bench::codec_job const &job, thread_pool &pool) -> void {
+  temp_file src, enc, dec;
+  if (!src.ok() || !enc.ok() || !dec.ok() || !src.write(job.data, job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: cannot create temporary files\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  bench::reset_peak();
+
+  bool ok = true;
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++)
+      ok = compress<dataT>(pool, src.path(), enc.path(), job.block_size, bits) && ok;
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++)
+      ok = decompress<dataT>(pool, enc.path(), dec.path()) && ok;
+  };
+
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  mapped_file const e(enc.path());
+  mapped_file const d(dec.path());
+  if (!ok || !e.ok() || !d.ok() || d.size() != job.size
+      || (job.size > 0 && 0 != std::memcmp(job.data, d.data(), job.size))) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: file round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, job.block_size, pool.size(), "file", job.size, e.size(),
+                static_cast<double>(job.size) / e.size(),
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+//! Whether the file at path holds a container of dataT that decodes to the
+//! n bytes at p.
+template <class dataT>
+auto same_container(char const *path, byte const *p, std::size_t const &n, thread_pool &pool) -> bool {
+  mapped_file const m(path);
+  if (!m.ok())
+    return false;
+  container_reader<dataT> const r(m.data(), m.size());
+  buffer dec(n);
+  return r.ok() && r.size() == n && r.decode(pool, 0, n, dec.data()) && (0 == n || 0 == std::memcmp(p, dec.data(), n));
+}
+
+template <class dataT>
+auto run_pipeline(char const *type, bench::codec_job const &job, thread_pool &pool) -> void {
+  temp_file src, enc;
+  // the output starts out twice as long as the input, and the offset of the
+  // descriptor is left past the end, so the second write below lengthens it
+  // again once it has been cut down.
+  if (!src.ok() || !enc.ok() || !src.write(job.data, job.size)
+      || !enc.write(job.data, job.size) || !enc.write(job.data, job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: cannot create temporary files\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  pipeline<dataT> const p(pool, job.block_size, bits);
+
+  bench::reset_peak();
+
+  bool ok = true;
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++)
+      ok = p.compress(src.fd(), enc.fd()) && ok;
+  };
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const peak = bench::peak_bytes();
+
+  ok = ok && same_container<dataT>(enc.path(), job.data, job.size, pool);
+
+  // and through blocking calls, where the timed runs went through io_uring.
+  if (ok && job.size > 0) {
+    blocking_queue q;
+    ok = enc.write(job.data, job.size) && p.compress(q, src.fd(), enc.fd())
+      && same_container<dataT>(enc.path(), job.data, job.size, pool);
+  }
+
+  mapped_file const e(enc.path());
+  if (!ok || !e.ok()) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: pipeline round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  // only compression is streamed; its output is read like any container.
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, job.block_size, pool.size(), "pipeline", job.size, e.size(),
+                static_cast<double>(job.size) / e.size(), mb / (te.ns * 1e-9), 0, peak });
+}
+
+template <class dataT>
+auto run_order1(char const *type, bench::codec_job const &job) -> void {
+  using codec = order1_rans<dataT>;
+
+  auto const block  = job.block_size;
+  auto const blocks = (job.size + block - 1) / block;
+
+  bench::reset_peak();
+
+  buffer tables(blocks * order1_table_bound);
+  internal::vector<std::size_t> len(blocks);
+  internal::vector<std::size_t> tlen(blocks);
+  buffer enc(blocks * codec::bound(block));
+  buffer dec(job.size);
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < blocks; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+
+        internal::vector<freq> h(order1_contexts * codec::alphabet);
+        codec::histogram(job.data + at, n, h);
+        normalize_order1(h, bits);
+        auto *const t = tables.data() + b * order1_table_bound;
+        tlen[b] = static_cast<std::size_t>(put_order1_table(h, t) - t);
+
+        codec const c(h, bits);
+        len[b] = c.encode(job.data + at, n, enc.data() + b * codec::bound(block));
+      }
+      bench::clobber();
+    }
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < blocks; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+
+        internal::vector<freq> h(order1_contexts * codec::alphabet);
+        get_order1_table(tables.data() + b * order1_table_bound, tlen[b], bits, h);
+        codec const c(h, bits);
+        c.decode(enc.data() + b * codec::bound(block), len[b], n, dec.data() + at);
+      }
+      bench::clobber();
+    }
+  };
+
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  if (0 != std::memcmp(job.data, dec.data(), job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: order-1 round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  std::size_t encoded = 0;
+  for (std::size_t b = 0; b < blocks; b++)
+    encoded += len[b] + tlen[b];
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, block, 1, "order1", job.size, encoded,
+                static_cast<double>(job.size) / encoded,
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+template <class dataT>
+auto run_adaptive(char const *type, bench::codec_job const &job) -> void {
+  using codec = adaptive_rans<dataT>;
+
+  auto const block = job.block_size;
+  auto const msgs  = (job.size + block - 1) / block;
+  codec const c;
+
+  bench::reset_peak();
+
+  internal::vector<std::size_t> len(msgs);
+  buffer enc(msgs * codec::bound(block));
+  buffer dec(job.size);
+
+  auto const encode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < msgs; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+        len[b] = c.encode(job.data + at, n, enc.data() + b * codec::bound(block));
+      }
+      bench::clobber();
+    }
+  };
+
+  auto const decode = [&](std::size_t const iters) {
+    for (std::size_t it = 0; it < iters; it++) {
+      for (std::size_t b = 0; b < msgs; b++) {
+        auto const at = b * block;
+        auto const n  = at + block < job.size ? block : job.size - at;
+        c.decode(enc.data() + b * codec::bound(block), len[b], n, dec.data() + at);
+      }
+      bench::clobber();
+    }
+  };
+
+  auto const te = bench::measure(job.min_ns, encode, 1);
+  auto const td = bench::measure(job.min_ns, decode, 1);
+
+  if (0 != std::memcmp(job.data, dec.data(), job.size)) {
+    std::fprintf(stderr, "comp-bench-codec: %s %s %s: adaptive round trip mismatch\n",
+                 isa_name(this_isa), type, job.corpus);
+    return;
+  }
+
+  std::size_t encoded = 0;
+  for (auto const &l : len)
+    encoded += l;
+
+  auto const mb = static_cast<double>(job.size) / 1e6;
+  bench::emit({ isa_name(this_isa), type, job.corpus, block, 1, "adaptive", job.size, encoded,
+                static_cast<double>(job.size) / encoded,
+                mb / (te.ns * 1e-9), mb / (td.ns * 1e-9), bench::peak_bytes() });
+}
+
+auto bench_codec(bench::codec_job const *job) -> void {
+  run<scalar>("scalar", *job);
+#if defined(__AVX512F__) || defined(__AVX2__)
+  run<simd<4>>("simd<4>", *job);
+#endif
+#if defined(__AVX512F__)
+  run<simd<8>>("simd<8>", *job);
+  run<simd<16>>("simd<16>", *job);
+#endif
+
+  thread_pool pool;
+  run_parallel<scalar>("scalar", *job, pool);
+#if defined(__AVX512F__) || defined(__AVX2__)
+  run_parallel<simd<4>>("simd<4>", *job, pool);
+#endif
+#if defined(__AVX512F__)
+  run_parallel<simd<8>>("simd<8>", *job, pool);
+  run_parallel<simd<16>>("simd<16>", *job, pool);
+#endif
+
+  run_container<scalar>("scalar", *job, pool);
+#if defined(__AVX512F__) || defined(__AVX2__)
+  run_container<simd<4>>("simd<4>", *job, pool);
+#endif
+#if defined(__AVX512F__)
+  run_container<simd<8>>("simd<8>", *job, pool);
+  run_container<simd<16>>("simd<16>", *job, pool);
+#endif
+
+  // the widest type of the instruction set is enough to cover the file path.
+#if defined(__AVX512F__)
+  run_file<simd<8>>("simd<8>", *job, pool);
+  run_pipeline<simd<8>>("simd<8>", *job, pool);
+#elif defined(__AVX2__)
+  run_file<simd<4>>("simd<4>", *job, pool);
+  run_pipeline<simd<4>>("simd<4>", *job, pool);
+#else
+  run_file<scalar>("scalar", *job, pool);
+  run_pipeline<scalar>("scalar", *job, pool);
+#endif
+
+  if (job->block_size >= order1_min) {
+    run_order1<scalar>("scalar", *job);
+#if defined(__AVX512F__) || defined(__AVX2__)
+    run_order1<simd<4>>("simd<4>", *job);
+#endif
+#if defined(__AVX512F__)
+    run_order1<simd<8>>("simd<8>", *job);
+    run_order1<simd<16>>("simd<16>", *job);
+#endif
+  }
+
+  if (job->block_size <= adaptive_max) {
+    run_adaptive<scalar>("scalar", *job);
+#if defined(__AVX512F__) || defined(__AVX2__)
+    run_adaptive<simd<4>>("simd<4>", *job);
+#endif
+#if defined(__AVX512F__)
+    run_adaptive<simd<8>>("simd<8>", *job);
+    run_adaptive<simd<16>>("simd<16>", *job);
+#endif
+  }
+}
+
+} // namespace
+
+COMP_DISPATCH_DEFINE(bench_codec, &bench_codec)
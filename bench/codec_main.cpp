@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+#include <array>
+#include <cstdio>
+
+#include "core/dispatch.h"
+
+#include "bench.h"
+#include "corpus.h"
+
+//------------------------------------------------------------------------------
+// comp-bench-codec -- encode and decode throughput, compression ratio and peak
+// memory of the codec over synthetic corpora, for every block size, instruction
+// set and type the host supports, as json.
+//------------------------------------------------------------------------------
+int main(int argc, char **argv) {
+  comp::bench::options opt{ 100e6, nullptr, 8u << 20 };
+  if (!comp::bench::parse_args(argc, argv, opt))
+    return 1;
+
+  static std::size_t const block_sizes[] = { 256, 16u << 10, 64u << 10, 256u << 10, 1u << 20 };
+
+  std::array<comp_dispatch_bench_codec::type*, comp::core::isa_count> const variants{{
+    comp_dispatch_bench_codec::scalar,
+    comp_dispatch_bench_codec::avx2,
+    comp_dispatch_bench_codec::avx512f,
+    comp_dispatch_bench_codec::avx512dqvl,
+    comp_dispatch_bench_codec::avx512vbmi2
+  }};
+
+  auto const corpora = comp::bench::make_corpora(opt.size);
+  auto const host    = static_cast<int>(comp::core::host_isa());
+  for (auto const &c : corpora) {
+    for (auto const block : block_sizes) {
+      comp::bench::codec_job const job{ c.name, c.data.data(), c.data.size(), block, opt.min_ns };
+      for (int i = 0; i <= host; i++) {
+        // an emulated build has only the variant of its march
+        if (!variants[i])
+          continue;
+        std::fprintf(stderr, "comp-bench-codec: %s %zu %s\n", c.name, block,
+                     comp::core::isa_name(static_cast<comp::core::isa>(i)));
+        variants[i](&job);
+      }
+    }
+  }
+
+  return comp::bench::write_json("codec", opt.path) ? 0 : 1;
+}
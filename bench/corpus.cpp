@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: MIT
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "corpus.h"
+
+namespace comp {
+namespace bench {
+
+namespace {
+
+using rng = std::mt19937_64;
+
+//! Sampler over ranks 0..n-1 with probability proportional to 1 / (rank + 1)^s.
+class zipf {
+  private:
+    std::vector<double> cdf_;
+
+  public:
+    zipf(std::size_t const &n, double const &s) : cdf_(n) {
+      double sum = 0;
+      for (std::size_t i = 0; i < n; i++)
+        cdf_[i] = (sum += 1.0 / std::pow(static_cast<double>(i + 1), s));
+      for (auto &c : cdf_)
+        c /= sum;
+    }
+
+    auto operator()(rng &g) const -> std::size_t {
+      auto const u = std::uniform_real_distribution<double>(0, 1)(g);
+      auto const i = std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin();
+      return std::min(static_cast<std::size_t>(i), cdf_.size() - 1);
+    }
+};
+
+auto uniform(std::size_t const &size, rng &g) -> std::vector<std::uint8_t> {
+  std::vector<std::uint8_t> d(size);
+  for (auto &c : d)
+    c = static_cast<std::uint8_t>(g());
+  return d;
+}
+
+auto geometric(std::size_t const &size, rng &g) -> std::vector<std::uint8_t> {
+  std::geometric_distribution<int> dist(0.2);
+  std::vector<std::uint8_t> d(size);
+  for (auto &c : d)
+    c = static_cast<std::uint8_t>(std::min(dist(g), 255));
+  return d;
+}
+
+auto zipfian(std::size_t const &size, rng &g) -> std::vector<std::uint8_t> {
+  zipf const z(256, 1.1);
+
+  // ranks are mapped to a fixed permutation of the bytes.
+  std::uint8_t perm[256];
+  for (int i = 0; i < 256; i++)
+    perm[i] = static_cast<std::uint8_t>(i);
+  std::shuffle(perm, perm + 256, g);
+
+  std::vector<std::uint8_t> d(size);
+  for (auto &c : d)
+    c = perm[z(g)];
+  return d;
+}
+
+auto runs(std::size_t const &size, rng &g) -> std::vector<std::uint8_t> {
+  static std::uint8_t const symbols[] = { 0x00, 0x20, 0x41, 0xff };
+  std::geometric_distribution<int> len(1.0 / 32);
+
+  std::vector<std::uint8_t> d;
+  d.reserve(size);
+  while (d.size() < size) {
+    auto const c = symbols[g() % sizeof(symbols)];
+    auto const n = std::min<std::size_t>(1 + len(g), size - d.size());
+    d.insert(d.end(), n, c);
+  }
+  return d;
+}
+
+auto text(std::size_t const &size, rng &g) -> std::vector<std::uint8_t> {
+  // relative frequencies of a..z in english prose.
+  static double const letters[] = {
+    8.2, 1.5, 2.8, 4.3, 12.7, 2.2, 2.0, 6.1, 7.0, 0.15, 0.77, 4.0, 2.4,
+    6.7, 7.5, 1.9, 0.095, 6.0, 6.3, 9.1, 2.8, 0.98, 2.4, 0.15, 2.0, 0.074
+  };
+  std::discrete_distribution<int> letter(std::begin(letters), std::end(letters));
+  std::uniform_int_distribution<int> length(1, 10);
+
+  std::vector<std::string> vocabulary(4096);
+  for (auto &w : vocabulary) {
+    auto const n = length(g);
+    for (int i = 0; i < n; i++)
+      w.push_back(static_cast<char>('a' + letter(g)));
+  }
+  zipf const word(vocabulary.size(), 1.0);
+
+  std::vector<std::uint8_t> d;
+  d.reserve(size + 16);
+  bool capital = true;
+  while (d.size() < size) {
+    auto const &w = vocabulary[word(g)];
+    auto const at = d.size();
+    d.insert(d.end(), w.begin(), w.end());
+    if (capital)
+      d[at] = static_cast<std::uint8_t>(d[at] - 'a' + 'A');
+
+    auto const r = g() % 100;
+    capital = r < 8;
+    if (r < 6)
+      d.push_back('.');
+    else if (r < 8)
+      d.push_back('\n');
+    else if (r < 14)
+      d.push_back(',');
+    d.push_back(r < 8 && r >= 6 ? '\n' : ' ');
+  }
+  d.resize(size);
+  return d;
+}
+
+} // namespace
+
+auto make_corpora(std::size_t const &size, std::uint64_t const &seed) -> std::vector<corpus> {
+  rng g(seed);
+
+  std::vector<corpus> c;
+  c.push_back({ "uniform",   uniform(size, g) });
+  c.push_back({ "geometric", geometric(size, g) });
+  c.push_back({ "zipf",      zipfian(size, g) });
+  c.push_back({ "runs",      runs(size, g) });
+  c.push_back({ "text",      text(size, g) });
+  return c;
+}
+
+} // namespace bench
+} // namespace comp
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_BENCH_CORPUS_H
+#define COMP_BENCH_CORPUS_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// synthetic corpora, generated deterministically so runs are comparable
+// across machines without any downloads:
+//
+//   uniform    -- independent uniform bytes, incompressible
+//   geometric  -- bytes from a geometric distribution, p = 0.2
+//   zipf       -- bytes ranked by a zipf distribution, s = 1.1
+//   runs       -- runs of a few symbols with a mean length of 32
+//   text       -- words of a zipfian vocabulary with english letter
+//                 frequencies, spaces, punctuation and line breaks
+//------------------------------------------------------------------------------
+namespace comp {
+namespace bench {
+
+struct corpus {
+  char const               *name;
+  std::vector<std::uint8_t> data;
+};
+
+//! Generate every corpus with size bytes each.
+auto make_corpora(std::size_t const &size, std::uint64_t const &seed = 1) -> std::vector<corpus>;
+
+} // namespace bench
+} // namespace comp
+
+#endif // COMP_BENCH_CORPUS_H
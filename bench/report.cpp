@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: MIT
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <malloc.h>
+
+#include "core/dispatch.h"
+
+#include "bench.h"
+
+namespace comp {
+namespace bench {
+
+namespace {
+
+std::vector<op_sample>    op_samples;
+std::vector<codec_sample> codec_samples;
+
+std::atomic<std::size_t> heap_cur{ 0 };
+std::atomic<std::size_t> heap_peak{ 0 };
+std::size_t              heap_base = 0;
+
+} // namespace
+
+auto emit(op_sample const &s) -> void {
+  op_samples.push_back(s);
+}
+
+auto emit(codec_sample const &s) -> void {
+  codec_samples.push_back(s);
+}
+
+auto reset_peak() -> void {
+  heap_base = heap_cur.load();
+  heap_peak.store(heap_base);
+}
+
+auto peak_bytes() -> std::size_t {
+  return heap_peak.load() - heap_base;
+}
+
+auto write_json(char const *benchmark, char const *path) -> bool {
+  FILE *f = path ? std::fopen(path, "w") : stdout;
+  if (!f)
+    return false;
+
+  std::fprintf(f, "{\n");
+  std::fprintf(f, "  \"benchmark\": \"%s\",\n", benchmark);
+  std::fprintf(f, "  \"host_isa\": \"%s\",\n", core::isa_name(core::host_isa()));
+  std::fprintf(f, "  \"results\": [");
+
+  char const *sep = "\n";
+  for (auto const &s : op_samples) {
+    std::fprintf(f, "%s    {\"isa\": \"%s\", \"type\": \"%s\", \"op\": \"%s\", \"mode\": \"%s\", "
+                    "\"ns_per_op\": %.4f, \"cycles_per_op\": %.3f, \"cycles_per_elem\": %.4f, "
+                    "\"gb_per_s\": %.3f}",
+                 sep, s.isa, s.type, s.op, s.mode,
+                 s.ns_per_op, s.cycles_per_op, s.cycles_per_elem, s.gb_per_s);
+    sep = ",\n";
+  }
+  for (auto const &s : codec_samples) {
+    std::fprintf(f, "%s    {\"isa\": \"%s\", \"type\": \"%s\", \"corpus\": \"%s\", \"block_size\": %zu, "
+                    "\"threads\": %zu, \"model\": \"%s\", \"input_bytes\": %zu, \"encoded_bytes\": %zu, "
+                    "\"ratio\": %.4f, \"encode_mb_per_s\": %.2f, \"decode_mb_per_s\": %.2f, \"peak_bytes\": %zu}",
+                 sep, s.isa, s.type, s.corpus, s.block_size, s.threads, s.model,
+                 s.input_bytes, s.encoded_bytes, s.ratio,
+                 s.encode_mb_per_s, s.decode_mb_per_s, s.peak_bytes);
+    sep = ",\n";
+  }
+
+  std::fprintf(f, "\n  ]\n}\n");
+
+  if (path)
+    std::fclose(f);
+  return true;
+}
+
+auto parse_args(int argc, char **argv, options &opt) -> bool {
+  for (int i = 1; i < argc; i++) {
+    if (0 == std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+      opt.min_ns = std::atof(argv[++i]) * 1e6;
+    } else if (0 == std::strcmp(argv[i], "--out") && i + 1 < argc) {
+      opt.path = argv[++i];
+    } else if (0 == std::strcmp(argv[i], "--size") && i + 1 < argc) {
+      opt.size = static_cast<std::size_t>(std::atof(argv[++i]) * (1 << 20));
+    } else {
+      std::fprintf(stderr, "usage: %s [--min-time <ms>] [--out <file.json>] [--size <MiB>]\n", argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace bench
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// heap accounting for peak_bytes(). The parallel coders allocate on the
+// workers of a thread pool, so the counters are atomic and the peak is raised
+// by compare and swap; reset_peak() and peak_bytes() are only called between
+// runs, from the thread that drives them.
+//------------------------------------------------------------------------------
+auto operator new(std::size_t n) -> void* {
+  void *p = std::malloc(n ? n : 1);
+  if (!p)
+    throw std::bad_alloc();
+
+  auto &peak = comp::bench::heap_peak;
+  auto const m    = malloc_usable_size(p);
+  auto const cur  = comp::bench::heap_cur.fetch_add(m) + m;
+  auto       seen = peak.load(std::memory_order_relaxed);
+  while (cur > seen && !peak.compare_exchange_weak(seen, cur, std::memory_order_relaxed))
+    ;
+  return p;
+}
+
+auto operator delete(void *p) noexcept -> void {
+  if (p)
+    comp::bench::heap_cur.fetch_sub(malloc_usable_size(p));
+  std::free(p);
+}
+
+auto operator delete(void *p, std::size_t) noexcept -> void {
+  operator delete(p);
+}
@@ -0,0 +1,76 @@
+#-------------------------------------------------------------------------------
+# comp_dispatch_sources -- compile kernel sources once per instruction set
+#
+#   comp_dispatch_sources(<target> <source>...)
+#
+# Each source is built once for every instruction set known to
+# core/dispatch.h and the resulting objects are added to <target>.  Sources
+# register their kernels with COMP_DISPATCH_DEFINE().
+#
+# The library keeps its inline code in a namespace per instruction set (see
+# core/internal/isa.h), but inline functions and templates from elsewhere,
+# those of the standard library above all, are emitted by every object and
+# merged by the linker, which keeps the first copy it sees.  CMake links the
+# objects of <target>'s own sources, built without -m flags, and then these in
+# the order they are added, so the scalar objects come ahead of every other
+# variant and the copy kept is one that runs on any host.  An archive gives no
+# such order, so <target> must be an executable or a shared library.  Link
+# time optimization would merge those copies by its own rules, so it is kept
+# off for these objects whatever INTERPROCEDURAL_OPTIMIZATION is set to.
+#
+# When an architecture is emulated (COMP_EMU_MARCH), sources are built once,
+# without -m flags, and the emulated march is the only variant.
+#-------------------------------------------------------------------------------
+function(comp_dispatch_sources target)
+  get_target_property(type ${target} TYPE)
+  if (NOT type MATCHES "^(EXECUTABLE|SHARED_LIBRARY|MODULE_LIBRARY)$")
+    message(FATAL_ERROR "comp_dispatch_sources: ${target} is a ${type}, "
+                        "whose link order cannot be kept")
+  endif ()
+
+  # kept local so the function also works from a parent directory scope
+  if ("${COMP_EMU_MARCH}" STREQUAL "")
+    set(isas scalar avx2 avx512f avx512dqvl avx512vbmi2)
+  else ()
+    set(isas scalar)
+  endif ()
+
+  set(flags_scalar      "")
+  set(flags_avx2        -mavx2)
+  # every AVX-512 host has CD, and every one with VBMI2 has VPOPCNTDQ, so
+  # these come with the tiers rather than making tiers of their own; keep in
+  # step with cpuid_isa().
+  set(flags_avx512f     -mavx512f -mavx512cd)
+  set(flags_avx512dqvl  -mavx512f -mavx512cd -mavx512dq -mavx512vl)
+  set(flags_avx512vbmi2 -mavx512f -mavx512cd -mavx512dq -mavx512vl -mavx512bw -mavx512vbmi2
+                        -mavx512ifma -mavx512vpopcntdq)
+
+  foreach (isa ${isas})
+    set(obj ${target}_dispatch_${isa})
+
+    add_library(${obj} OBJECT ${ARGN})
+
+    set_target_properties(${obj} PROPERTIES
+      CXX_STANDARD 17
+      CXX_STANDARD_REQUIRED ON
+      POSITION_INDEPENDENT_CODE ON
+      INTERPROCEDURAL_OPTIMIZATION OFF
+    )
+
+    target_include_directories(${obj} PRIVATE
+      $<TARGET_PROPERTY:comp,INTERFACE_INCLUDE_DIRECTORIES>
+      $<TARGET_PROPERTY:${target},INCLUDE_DIRECTORIES>
+    )
+    target_compile_definitions(${obj} PRIVATE
+      $<TARGET_PROPERTY:${target},COMPILE_DEFINITIONS>
+    )
+    target_compile_options(${obj} PRIVATE
+      $<TARGET_PROPERTY:comp,INTERFACE_COMPILE_OPTIONS>
+      $<TARGET_PROPERTY:${target},COMPILE_OPTIONS>
+      ${flags_${isa}}
+    )
+
+    # in the order of isas, so scalar first, see above
+    target_sources(${target} PRIVATE $<TARGET_OBJECTS:${obj}>)
+  endforeach ()
+endfunction ()
@@ -0,0 +1,376 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_ADAPTIVE_H
+#define COMP_CORE_ADAPTIVE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "stream.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// adaptive order-0 rANS.
+//
+// The model starts out uniform and learns from the symbols as they are coded,
+// so nothing is stored ahead of the rANS bytes and a message is coded in one
+// pass over its symbols. That is what short messages need, whose frequency
+// table would cost more than it saves. The coder is the interleaved one of
+// rans.h, every lane of a vector coding with the same model, which learns
+// from all the lanes of a vector once they are coded.
+//
+// Counts are kept per lane, so a vector of symbols is counted with a gather,
+// an add and a scatter that no two lanes collide in. Every so often the table
+// is rebuilt from them: the lanes are summed, the sum halved when it exceeds
+// limit, which lets old statistics fade, and every symbol gets
+//
+//   f = 1 + (count * q) >> 16,  q = ((M - 256) << 16) / total
+//
+// so that it stays codeable, with what rounding leaves of M = 2^bits spread
+// over all of them. The cumulative frequencies are a prefix sum, lane-wise
+// within a vector and carried across. Every step is a vector op over the 256
+// entries. Rebuilds come after 1, 2, 4, ... vectors, up to one every period
+// symbols, so the model settles quickly at the start of a message.
+//
+// The decoder finds the symbol of a slot with a binary search over the
+// cumulative frequencies, one gather per step for all lanes at once. Since
+// rANS encodes back to front, the encoder first runs the model forward and
+// records the frequencies every vector was coded with.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Adaptive order-0 model over byte symbols, shared by every lane of dataT.
+template <class dataT>
+class adaptive_model {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    static constexpr auto half  = data_traits<dataT>::unit_width / 2;
+
+  public:
+    //! number of distinct symbols
+    static constexpr std::size_t alphabet = 256;
+    //! total count beyond which the counts are halved
+    static constexpr unitT limit = static_cast<unitT>(1) << 16;
+
+  private:
+    int         bits_;
+    std::size_t period_;
+    //! vectors between the last rebuild and the next, and left until it
+    std::size_t step_;
+    std::size_t next_;
+    //! one table of counts per lane
+    internal::vector<unitT> cnt_;
+    //! f in the upper half of the unit, c in the lower half
+    internal::vector<unitT> tab_;
+    //! lane * alphabet, to count every lane in its own table
+    baseT off_;
+
+    auto rebuild() -> void;
+
+  public:
+    // Ctors
+    //! bits in [10, 16], and a rebuild at least once every period symbols.
+    adaptive_model(int const &bits, std::size_t const &period);
+
+    //! Frequency, in the upper half, and cumulative frequency, in the lower
+    //! half of the unit, of the symbol of every lane.
+    auto operator()(dataT const &s) const -> dataT {
+      return abi::gather(static_cast<baseT>(s), tab_.data());
+    }
+    //! Symbol owning the slot of every lane.
+    auto find(dataT const &slot) const -> dataT;
+
+    //! Learn from a vector of symbols, rebuilding the table when due.
+    auto update(dataT const &s) -> void;
+};
+
+//! Interleaved rANS coder for byte symbols over an adaptive order-0 model.
+template <class dataT>
+class adaptive_rans {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+    using model = adaptive_model<dataT>;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    static constexpr auto half  = data_traits<dataT>::unit_width / 2;
+
+  public:
+    //! lower bound of a coder state
+    static constexpr unitT lower = static_cast<unitT>(1) << 23;
+    //! supported range of the model precision; every symbol holds at least
+    //! one of the 2^bits slots, so more slots let the rest be finer
+    static constexpr int min_bits     = 10;
+    static constexpr int max_bits     = 16;
+    static constexpr int default_bits = 15;
+    //! default longest run of symbols between rebuilds of the model
+    static constexpr std::size_t default_period = 1024;
+
+  private:
+    int         bits_;
+    std::size_t period_;
+
+    auto encode_step(baseT const &x, baseT const &e, reverse_stream<dataT> &os) const -> baseT;
+    auto decode_step(baseT const &x, model &m, byte *out, bounded_stream<dataT> &is) const -> baseT;
+
+  public:
+    // Ctors
+    //! bits in [min_bits, max_bits], and period > 0. Throws
+    //! std::invalid_argument if bits is out of range.
+    explicit adaptive_rans(int const &bits = default_bits, std::size_t const &period = default_period)
+      : bits_(bits), period_(period)
+    {
+      if (bits < min_bits || bits > max_bits)
+        throw std::invalid_argument("adaptive_rans: bits out of range");
+    }
+
+    //! Upper bound on the encoded size of n symbols.
+    static auto bound(std::size_t const &n) -> std::size_t {
+      return 2 * (n + arity) + 4 * arity + arity;
+    }
+
+    //! Encode n symbols into out, which must hold bound(n) bytes, and return
+    //! the number of bytes written.
+    auto encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t;
+    //! Decode n symbols from the size bytes at in, which must be the output of
+    //! encode() with the same bits and period. Returns false if in is found
+    //! to be truncated or corrupt, as rans<>::decode().
+    auto decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool;
+};
+
+//==============================================================================
+// adaptive_model
+//==============================================================================
+template <class dataT>
+inline adaptive_model<dataT>::adaptive_model(int const &bits, std::size_t const &period)
+  : bits_(bits), period_(period / arity ? period / arity : 1), step_(1), next_(1),
+    cnt_(arity * alphabet), tab_(alphabet), off_(abi::set(0))
+{
+  if constexpr (1 < arity) {
+    byte iota[arity];
+    for (int j = 0; j < arity; j++)
+      iota[j] = static_cast<byte>(j);
+    off_ = abi::bsl(abi::get(iota), 8);
+  }
+  rebuild();
+}
+
+template <class dataT>
+inline auto adaptive_model<dataT>::rebuild() -> void {
+  auto *const cnt = cnt_.data();
+  auto *const tab = tab_.data();
+  auto const  m   = static_cast<unitT>(1) << bits_;
+
+  // fold every lane into the first table.
+  unitT total = 0;
+  for (std::size_t s = 0; s < alphabet; s += arity) {
+    auto v = abi::lod(cnt + s);
+    for (std::size_t l = 1; l < arity; l++) {
+      v = abi::add(v, abi::lod(cnt + l * alphabet + s));
+      abi::cpy(cnt + l * alphabet + s, abi::set(0));
+    }
+    abi::cpy(cnt + s, v);
+    total += abi::hadd(v);
+  }
+
+  if (total > limit) {
+    total = 0;
+    for (std::size_t s = 0; s < alphabet; s += arity) {
+      auto const v = abi::bsr(abi::lod(cnt + s), 1);
+      abi::cpy(cnt + s, v);
+      total += abi::hadd(v);
+    }
+  }
+
+  // q is below 2^32 / total, so no product with a count wraps a 32-bit unit.
+  auto const q = static_cast<unitT>(total ? (static_cast<std::uint64_t>(m - alphabet) << 16) / total : 0);
+
+  unitT sum = 0;
+  for (std::size_t s = 0; s < alphabet; s += arity) {
+    auto const f = abi::add(abi::bsr(abi::mul(abi::lod(cnt + s), abi::set(q)), 16), abi::set(1));
+    abi::cpy(tab + s, f);
+    sum += abi::hadd(f);
+  }
+
+  // what rounding left over, evenly, the odd ones to the lowest symbols.
+  auto const left = m - sum;
+  auto const even = abi::set(left / alphabet);
+  auto const odd  = abi::set(left % alphabet);
+
+  byte iota[arity];
+  for (int j = 0; j < arity; j++)
+    iota[j] = static_cast<byte>(j);
+  auto idx = abi::get(iota);
+
+  auto carry = abi::set(0);
+  for (std::size_t s = 0; s < alphabet; s += arity) {
+    auto f = abi::add(abi::lod(tab + s), even);
+    f = abi::madd(abi::cmpgt(odd, idx), f, abi::set(1));
+
+    auto const c = abi::add(abi::escan(f), carry);
+    abi::cpy(tab + s, abi::lor(abi::bsl(f, half), c));
+
+    carry = abi::add(carry, abi::set(abi::hadd(f)));
+    idx   = abi::add(idx, abi::set(arity));
+  }
+}
+
+template <class dataT>
+inline auto adaptive_model<dataT>::find(dataT const &slot) const -> dataT {
+  auto const lo = abi::set((static_cast<unitT>(1) << half) - 1);
+
+  // the largest symbol whose cumulative frequency does not exceed the slot.
+  auto s = abi::set(0);
+  for (unitT step = alphabet / 2; step; step >>= 1) {
+    auto const t = abi::add(s, abi::set(step));
+    auto const c = abi::land(abi::gather(t, tab_.data()), lo);
+    s = abi::madd(abi::cmple(c, static_cast<baseT>(slot)), s, abi::set(step));
+  }
+  return s;
+}
+
+template <class dataT>
+inline auto adaptive_model<dataT>::update(dataT const &s) -> void {
+  auto const i = abi::add(static_cast<baseT>(s), off_);
+  abi::scatter(cnt_.data(), i, abi::add(abi::gather(i, cnt_.data()), abi::set(1)));
+
+  if (0 == --next_) {
+    rebuild();
+    step_ = 2 * step_ < period_ ? 2 * step_ : period_;
+    next_ = step_;
+  }
+}
+
+//==============================================================================
+// adaptive_rans
+//==============================================================================
+template <class dataT>
+inline auto adaptive_rans<dataT>::encode_step(baseT const &x, baseT const &e, reverse_stream<dataT> &os) const -> baseT {
+  auto const f  = abi::bsr(e, half);
+  auto const c  = abi::land(e, abi::set((static_cast<unitT>(1) << half) - 1));
+  auto const xm = abi::bsl(f, 31 - bits_);
+
+  // shift out the low bytes of every lane that would overflow.
+  auto y = x;
+  for (maskT k; (k = abi::cmple(xm, y));) {
+    os.masked_write(dataT(y), k);
+    y = abi::mbsr(k, y, 8);
+  }
+
+  // the model changes too often for reciprocals to pay off.
+  baseT r;
+  auto const q = abi::divmod(y, f, r);
+  return abi::add(abi::bsl(q, bits_), abi::add(r, c));
+}
+
+template <class dataT>
+inline auto adaptive_rans<dataT>::decode_step(baseT const &x, model &m, byte *out,
+                                              bounded_stream<dataT> &is) const -> baseT {
+  auto const slot = abi::land(x, abi::set((static_cast<unitT>(1) << bits_) - 1));
+  auto const s    = static_cast<baseT>(m.find(dataT(slot)));
+  auto const e    = static_cast<baseT>(m(dataT(s)));
+  auto const f    = abi::bsr(e, half);
+  auto const c    = abi::land(e, abi::set((static_cast<unitT>(1) << half) - 1));
+
+  abi::put(out, s);
+  m.update(dataT(s));
+  auto y = abi::muladd52(f, abi::bsr(x, bits_), abi::sub(slot, c));
+
+  // as rans<>, count the bytes of every lane, then read the groups back.
+  maskT k[4];
+  int t = 0;
+  for (auto z = y; t < 4 && (k[t] = abi::cmpgt(abi::set(lower), z)); t++)
+    z = abi::mbsl(k[t], z, 8);
+  while (t--) {
+    dataT b(abi::set(0));
+    is.masked_read(b, k[t]);
+    y = abi::lor(abi::mbsl(k[t], y, 8), static_cast<baseT>(b));
+  }
+
+  return y;
+}
+
+template <class dataT>
+inline auto adaptive_rans<dataT>::encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t {
+  auto const nv = n / arity;
+  auto const r  = n % arity;
+  auto const ng = nv + (r ? 1 : 0);
+
+  // pad the partial vector with a symbol that is known to be codeable.
+  byte tail[arity];
+  if (r) {
+    std::memset(tail, in[n - 1], arity);
+    std::memcpy(tail, in + nv * arity, r);
+  }
+
+  // the model as the decoder will see it, vector by vector.
+  internal::vector<unitT> rec(ng * arity);
+  model m(bits_, period_);
+  for (std::size_t i = 0; i < ng; i++) {
+    auto const s = dataT(abi::get(i < nv ? in + i * arity : tail));
+    abi::cpy(rec.data() + i * arity, static_cast<baseT>(m(s)));
+    m.update(s);
+  }
+
+  reverse_stream<dataT> os(out, bound(n));
+
+  auto x = abi::set(lower);
+  for (auto i = ng; i-- > 0;)
+    x = encode_step(x, abi::lod(rec.data() + i * arity), os);
+
+  // flush the full states, lowest byte last.
+  for (int i = 0; i < 4; i++) {
+    os.write(dataT(x));
+    x = abi::bsr(x, 8);
+  }
+
+  auto const size = static_cast<std::size_t>(out + bound(n) - os.pos());
+  std::memmove(out, os.pos(), size);
+  return size;
+}
+
+template <class dataT>
+inline auto adaptive_rans<dataT>::decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool {
+  auto const nv = n / arity;
+  auto const r  = n % arity;
+
+  bounded_stream<dataT> is(in, size);
+  model m(bits_, period_);
+
+  auto x = abi::set(0);
+  for (int i = 0; i < 4; i++) {
+    dataT b(abi::set(0));
+    is.read(b);
+    x = abi::lor(abi::bsl(x, 8), static_cast<baseT>(b));
+  }
+
+  for (std::size_t i = 0; i < nv; i++)
+    x = decode_step(x, m, out + i * arity, is);
+
+  if (r) {
+    byte tail[arity];
+    x = decode_step(x, m, tail, is);
+    std::memcpy(out + nv * arity, tail, r);
+  }
+
+  // every lane ends where the encoder started it, unless in is corrupt.
+  return is.ok() && abi::mask_max == abi::cmpeq(x, abi::set(lower));
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_ADAPTIVE_H
@@ -2,6 +2,10 @@
 #ifndef COMP_CORE_ALGORITHM_H
 #define COMP_CORE_ALGORITHM_H 1
 
+#include <cstddef>
+
+#include "core/internal/isa.h"
+#include "divisor.h"
 #include "traits.h"
 
 //------------------------------------------------------------------------------
@@ -9,6 +13,7 @@
 //------------------------------------------------------------------------------
 namespace comp {
 namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 //==============================================================================
 // Algorithms
@@ -33,6 +38,167 @@ inline auto scatter(contT<unitT, alocT> &c, dataT const &vindex, dataT const &a)
   abi::scatter(c.data(), static_cast<base>(vindex), static_cast<base>(a));
 }
 
+//! Gather the reciprocal of a divisor table entry for each lane.
+template < template <class, class> class contT
+         , class alocT
+         , class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto gather(contT<reciprocal<unitT>, alocT> const &c, dataT const &vindex) -> divisor<dataT> {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  // each entry is two units wide, so both halves are gathered at 2 * vindex.
+  auto const i = abi::bsl(static_cast<base>(vindex), 1);
+  auto const *p = reinterpret_cast<unitT const*>(c.data());
+  return divisor<dataT>(abi::gather(i, p), abi::gather(i, p + 1));
+}
+
+//==============================================================================
+// Horizontal algorithms
+//==============================================================================
+//! Sum of the lanes, modulo the unit width.
+template < class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto reduce_add(dataT const &a) -> unitT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::hadd(static_cast<base>(a));
+}
+
+//! Smallest of the lanes.
+template < class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto reduce_min(dataT const &a) -> unitT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::hmin(static_cast<base>(a));
+}
+
+//! Largest of the lanes.
+template < class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto reduce_max(dataT const &a) -> unitT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::hmax(static_cast<base>(a));
+}
+
+//! Bitwise or of the lanes.
+template < class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto reduce_or(dataT const &a) -> unitT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::hlor(static_cast<base>(a));
+}
+
+//! Bitwise xor of the lanes.
+template < class dataT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto reduce_xor(dataT const &a) -> unitT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::heor(static_cast<base>(a));
+}
+
+//! Lane i holds the sum of lanes [0, i].
+template <class dataT>
+inline auto inclusive_scan(dataT const &a) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return dataT(abi::iscan(static_cast<base>(a)));
+}
+
+//! Lane i holds the sum of lanes [0, i).
+template <class dataT>
+inline auto exclusive_scan(dataT const &a) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return dataT(abi::escan(static_cast<base>(a)));
+}
+
+//! Lane i holds lane idx[i] of a; every index must be less than the arity.
+template <class dataT>
+inline auto permute(dataT const &a, dataT const &idx) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return dataT(abi::perm(static_cast<base>(a), static_cast<base>(idx)));
+}
+
+//! Every lane holds lane i of a.
+template <class dataT>
+inline auto broadcast(dataT const &a, unsigned int const &i) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return dataT(abi::bcst(static_cast<base>(a), i));
+}
+
+//==============================================================================
+// Bulk algorithms
+//==============================================================================
+//! default look-ahead of the bulk algorithms, in indices
+static constexpr std::size_t prefetch_distance = 64;
+
+//! Gather c[vindex[i]] into out[i] for every i in [0, n), prefetching the
+//! entry dist indices ahead.
+template < class dataT
+         , template <class, class> class contT
+         , class alocT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto gather(contT<unitT, alocT> const &c, unitT const *vindex, std::size_t const &n,
+                   unitT *out, std::size_t const &dist = prefetch_distance) -> void {
+  using abi   = typename data_traits<dataT>::abi;
+  using maskT = typename data_traits<dataT>::mask_type;
+
+  static constexpr std::size_t arity = data_traits<dataT>::arity;
+
+  auto const *p = c.data();
+
+  std::size_t i = 0;
+  for (; i + dist + arity <= n; i += arity) {
+    for (std::size_t j = 0; j < arity; j++)
+      __builtin_prefetch(p + vindex[i + dist + j], 0);
+    abi::cpy(out + i, abi::gather(abi::lod(vindex + i), p));
+  }
+  for (; i + arity <= n; i += arity)
+    abi::cpy(out + i, abi::gather(abi::lod(vindex + i), p));
+
+  if (i < n) {
+    auto const k = static_cast<maskT>(data_traits<dataT>::mask_max >> (arity - (n - i)));
+    abi::mcpy(out + i, k, abi::mgather(k, abi::mlod(k, vindex + i), p));
+  }
+}
+
+//! Scatter a[i] into c[vindex[i]] for every i in [0, n), prefetching the
+//! entry dist indices ahead. Duplicate indices keep the last value.
+template < class dataT
+         , template <class, class> class contT
+         , class alocT
+         , class unitT = typename data_traits<dataT>::unit_type >
+inline auto scatter(contT<unitT, alocT> &c, unitT const *vindex, std::size_t const &n,
+                    unitT const *a, std::size_t const &dist = prefetch_distance) -> void {
+  using abi   = typename data_traits<dataT>::abi;
+  using maskT = typename data_traits<dataT>::mask_type;
+
+  static constexpr std::size_t arity = data_traits<dataT>::arity;
+
+  auto *p = c.data();
+
+  std::size_t i = 0;
+  for (; i + dist + arity <= n; i += arity) {
+    for (std::size_t j = 0; j < arity; j++)
+      __builtin_prefetch(p + vindex[i + dist + j], 1);
+    abi::scatter(p, abi::lod(vindex + i), abi::lod(a + i));
+  }
+  for (; i + arity <= n; i += arity)
+    abi::scatter(p, abi::lod(vindex + i), abi::lod(a + i));
+
+  if (i < n) {
+    auto const k = static_cast<maskT>(data_traits<dataT>::mask_max >> (arity - (n - i)));
+    abi::mscatter(p, k, abi::mlod(k, vindex + i), abi::mlod(k, a + i));
+  }
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace core
 } // namespace comp
 
@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_ALLOCATOR_H
+#define COMP_CORE_ALLOCATOR_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+# include <sys/mman.h>
+#endif
+
+#include "core/internal/isa.h"
+
+//------------------------------------------------------------------------------
+// allocators for containers accessed with gather/scatter.
+//
+// Memory is aligned to a cache line, so no vector straddles two lines. Tables
+// of at least one huge page can be backed by huge pages as well, which keeps
+// random gathers across multi-MB tables from missing in the TLB:
+//
+//   pages::normal   -- aligned heap memory
+//   pages::thp      -- 2M aligned anonymous mapping, madvise(MADV_HUGEPAGE)
+//   pages::hugetlb  -- MAP_HUGETLB mapping, falling back to pages::thp
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! page backing of an allocation
+enum class pages : int {
+  normal,
+  thp,
+  hugetlb
+};
+
+//! alignment of every allocation
+static constexpr std::size_t cache_line = 64;
+//! size of a huge page
+static constexpr std::size_t huge_page = static_cast<std::size_t>(2) << 20;
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// raw allocation.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+inline auto round_up(std::size_t const &n, std::size_t const &align) -> std::size_t {
+  return (n + align - 1) / align * align;
+}
+
+//! Whether an allocation of the given size is served by a mapping.
+inline auto is_mapped(std::size_t const &bytes, pages const &p) -> bool {
+#if defined(__linux__)
+  return pages::normal != p && bytes >= huge_page;
+#else
+  (void)bytes;
+  (void)p;
+  return false;
+#endif
+}
+
+inline auto allocate(std::size_t const &bytes, pages const &p) -> void* {
+#if defined(__linux__)
+  if (is_mapped(bytes, p)) {
+    auto const len = round_up(bytes, huge_page);
+
+# if defined(MAP_HUGETLB)
+    if (pages::hugetlb == p) {
+      void *m = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (MAP_FAILED != m)
+        return m;
+    }
+# endif
+
+    // over-map by a huge page and trim, so the region is huge page aligned.
+    void *m = mmap(nullptr, len + huge_page, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == m)
+      throw std::bad_alloc();
+
+    auto const base = reinterpret_cast<std::uintptr_t>(m);
+    auto const head = round_up(base, huge_page) - base;
+    if (head)
+      munmap(m, head);
+    if (huge_page - head)
+      munmap(reinterpret_cast<void*>(base + head + len), huge_page - head);
+
+    m = reinterpret_cast<void*>(base + head);
+# if defined(MADV_HUGEPAGE)
+    madvise(m, len, MADV_HUGEPAGE);
+# endif
+    return m;
+  }
+#endif
+
+  void *m = std::aligned_alloc(cache_line, round_up(bytes ? bytes : 1, cache_line));
+  if (!m)
+    throw std::bad_alloc();
+  return m;
+}
+
+inline auto deallocate(void *m, std::size_t const &bytes, pages const &p) -> void {
+#if defined(__linux__)
+  if (is_mapped(bytes, p)) {
+    munmap(m, round_up(bytes, huge_page));
+    return;
+  }
+#endif
+  std::free(m);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// aligned allocator.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Cache line aligned allocator, optionally backed by huge pages.
+template <class T, pages P = pages::normal>
+class aligned_allocator {
+  public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind { using other = aligned_allocator<U, P>; };
+
+    // Ctors
+    aligned_allocator() = default;
+    template <class U>
+    aligned_allocator(aligned_allocator<U, P> const &) { }
+
+    auto allocate(std::size_t const &n) -> T* {
+      return static_cast<T*>(internal::allocate(n * sizeof(T), P));
+    }
+    auto deallocate(T *p, std::size_t const &n) -> void {
+      internal::deallocate(p, n * sizeof(T), P);
+    }
+};
+
+template <class T, class U, pages P>
+inline auto operator==(aligned_allocator<T, P> const &, aligned_allocator<U, P> const &) -> bool {
+  return true;
+}
+
+template <class T, class U, pages P>
+inline auto operator!=(aligned_allocator<T, P> const &, aligned_allocator<U, P> const &) -> bool {
+  return false;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// arena.
+//
+// Per-block tables are carved out of a few large chunks and released all at
+// once with reset(), which keeps the chunks for the next block.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Bump allocator over cache line aligned chunks.
+class arena {
+  private:
+    struct chunk {
+      void       *mem;
+      std::size_t size;
+    };
+
+    std::vector<chunk> chunks_;
+    std::size_t        size_;
+    pages              pages_;
+    std::size_t        cur_;
+    std::size_t        off_;
+
+  public:
+    // Ctors
+    explicit arena(std::size_t const &size = huge_page, pages const &p = pages::normal)
+      : size_(size), pages_(p), cur_(0), off_(0) { }
+    arena(arena const &) = delete;
+    auto operator=(arena const &) -> arena& = delete;
+
+    // Dtor
+    ~arena() {
+      for (auto const &c : chunks_)
+        internal::deallocate(c.mem, c.size, pages_);
+    }
+
+    //! Carve out bytes aligned to a cache line.
+    auto allocate(std::size_t const &bytes) -> void* {
+      auto const need = internal::round_up(bytes ? bytes : 1, cache_line);
+
+      while (cur_ < chunks_.size()) {
+        if (off_ + need <= chunks_[cur_].size) {
+          auto *m = static_cast<char*>(chunks_[cur_].mem) + off_;
+          off_ += need;
+          return m;
+        }
+        cur_++;
+        off_ = 0;
+      }
+
+      auto const size = need > size_ ? need : size_;
+      chunks_.push_back({ internal::allocate(size, pages_), size });
+      cur_ = chunks_.size() - 1;
+      off_ = need;
+      return chunks_[cur_].mem;
+    }
+
+    //! Release everything allocated so far, keeping the chunks.
+    auto reset() -> void {
+      cur_ = 0;
+      off_ = 0;
+    }
+};
+
+//! Allocator drawing from an arena; memory is only reclaimed by arena::reset.
+template <class T>
+class arena_allocator {
+  private:
+    template <class U>
+    friend class arena_allocator;
+
+    arena *arena_;
+
+  public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind { using other = arena_allocator<U>; };
+
+    // Ctors
+    explicit arena_allocator(arena &a) : arena_(&a) { }
+    template <class U>
+    arena_allocator(arena_allocator<U> const &other) : arena_(other.arena_) { }
+
+    auto allocate(std::size_t const &n) -> T* {
+      return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+    }
+    auto deallocate(T *, std::size_t const &) -> void { }
+
+    template <class U>
+    auto operator==(arena_allocator<U> const &other) const -> bool { return arena_ == other.arena_; }
+    template <class U>
+    auto operator!=(arena_allocator<U> const &other) const -> bool { return arena_ != other.arena_; }
+};
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_ALLOCATOR_H
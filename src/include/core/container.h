@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_CONTAINER_H
+#define COMP_CORE_CONTAINER_H 1
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "parallel.h"
+#include "rans.h"
+#include "thread_pool.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// seekable container.
+//
+// Blocks are coded on their own, as by parallel_rans, and found through an
+// index at the end, so any one of them can be decoded without the others:
+//
+//   header   | magic (4) | version (1) | arity (1) | bits (1) | 0 (1) | block (4) |
+//   block    | frequency table | final lane states (4 * arity) | rANS bytes |
+//            ...
+//   index    | compressed offset (8) | uncompressed offset (8) | per block
+//   trailer  | index offset (8) | blocks (8) | symbols (8) | magic (4) |
+//
+// All fields are little endian and compressed offsets count from the start of
+// the container. The final lane states are the coder states of every lane of
+// the data<> interleave, flushed when the block is done, which is where its
+// decoder starts. Since the index follows the blocks, a writer never needs to
+// know the size of a block before it is coded, and codes a few blocks per
+// worker at a time, so its scratch memory does not grow with the input.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Container layout shared by the writer and the reader.
+struct container_format {
+  static constexpr std::uint32_t header_magic  = 0x43504d43; // "CMPC"
+  static constexpr std::uint32_t trailer_magic = 0x49504d43; // "CMPI"
+  static constexpr std::uint8_t  version       = 1;
+
+  static constexpr std::size_t header_size  = 12;
+  static constexpr std::size_t entry_size   = 16;
+  static constexpr std::size_t trailer_size = 28;
+};
+
+//! Writes a whole container, coding the blocks over a thread pool.
+template <class dataT>
+class container_writer {
+  private:
+    using codec  = rans<dataT>;
+    using format = container_format;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+
+  public:
+    //! default block size, in symbols, small enough for cheap point queries
+    static constexpr std::size_t default_block = static_cast<std::size_t>(64) << 10;
+    static constexpr std::size_t max_block     = parallel_rans<dataT>::max_block;
+    static constexpr int default_bits = parallel_rans<dataT>::default_bits;
+    static constexpr int min_bits     = parallel_rans<dataT>::min_bits;
+    static constexpr int max_bits     = parallel_rans<dataT>::max_bits;
+
+  private:
+    thread_pool *pool_;
+    std::size_t  block_;
+    int          bits_;
+
+  public:
+    // Ctors
+    //! block in [1, max_block] and bits in [min_bits, max_bits]; the pool must
+    //! outlive the writer. Throws std::invalid_argument if either is out of
+    //! range.
+    explicit container_writer(thread_pool &pool, std::size_t const &block = default_block,
+                              int const &bits = default_bits);
+
+    //! Upper bound on the container size of n symbols.
+    auto bound(std::size_t const &n) const -> std::size_t {
+      auto const nb = (n + block_ - 1) / block_;
+      auto const r  = n - (nb ? nb - 1 : 0) * block_;
+      return format::header_size + nb * (table_size + format::entry_size) + format::trailer_size
+           + (nb ? (nb - 1) * codec::bound(block_) + codec::bound(r) : 0);
+    }
+
+    //! Write the header into out, which must hold container_format::header_size
+    //! bytes, and return the end of it.
+    auto put_header(byte *out) const -> byte*;
+    //! Write the index of a container of n symbols, whose blocks start at
+    //! off[0..blocks), and the trailer into out, which lies at byte at of the
+    //! container, and return the end of them.
+    auto put_index(std::uint64_t const *off, std::size_t const &n, std::size_t const &at,
+                   byte *out) const -> byte*;
+
+    //! Write n symbols as a container into out, which must hold bound(n)
+    //! bytes, and return its size.
+    auto encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t {
+      return encode(in, n, out, [](std::size_t const &, std::size_t const &) { });
+    }
+    //! As encode(), calling done(read, written) after every window of blocks
+    //! with the number of symbols read and bytes written so far; neither is
+    //! touched again by the blocks.
+    template <class fnT>
+    auto encode(byte const *in, std::size_t const &n, byte *out, fnT const &done) const -> std::size_t;
+};
+
+//! Random access to the blocks of a container held in memory.
+template <class dataT>
+class container_reader {
+  private:
+    using format = container_format;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+
+    byte const  *in_;
+    byte const  *index_;
+    std::size_t  n_;
+    std::size_t  blocks_;
+    std::size_t  block_;
+    int          bits_;
+    bool         ok_;
+
+    auto entry(std::size_t const &b, std::size_t const &field) const -> std::size_t {
+      std::uint64_t v;
+      std::memcpy(&v, index_ + b * format::entry_size + 8 * field, sizeof(v));
+      return static_cast<std::size_t>(v);
+    }
+
+  public:
+    // Ctors
+    //! The size bytes at in must outlive the reader.
+    container_reader(byte const *in, std::size_t const &size);
+
+    //! false unless the framing and the index of the container are intact and
+    //! it was written with the arity of dataT; the blocks themselves are only
+    //! checked as they are decoded.
+    auto ok() const -> bool { return ok_; }
+
+    //! number of symbols
+    auto size() const -> std::size_t { return n_; }
+    //! number of blocks
+    auto blocks() const -> std::size_t { return blocks_; }
+    //! symbols per block, except for the last
+    auto block_size() const -> std::size_t { return block_; }
+
+    //! first symbol of block b
+    auto offset(std::size_t const &b) const -> std::size_t { return entry(b, 1); }
+    //! first byte of block b within the container
+    auto start(std::size_t const &b) const -> std::size_t { return entry(b, 0); }
+    //! number of symbols of block b
+    auto length(std::size_t const &b) const -> std::size_t {
+      return (b + 1 < blocks_ ? entry(b + 1, 1) : n_) - entry(b, 1);
+    }
+    //! block holding symbol pos
+    auto block_of(std::size_t const &pos) const -> std::size_t { return pos / block_; }
+
+    //! Decode block b into out, which must hold length(b) symbols. Returns
+    //! false if the block is found to be truncated or corrupt.
+    auto decode_block(std::size_t const &b, byte *out) const -> bool;
+    //! Decode symbols [pos, pos + len), with pos + len <= size(), into out,
+    //! touching only the blocks that hold them. Returns false if any of them
+    //! is found to be truncated or corrupt.
+    auto decode(std::size_t const &pos, std::size_t const &len, byte *out) const -> bool;
+    //! As decode(), with the blocks decoded concurrently on pool.
+    auto decode(thread_pool &pool, std::size_t const &pos, std::size_t const &len, byte *out) const -> bool;
+
+  private:
+    auto decode_part(std::size_t const &b, std::size_t const &pos, std::size_t const &len, byte *out) const -> bool;
+};
+
+//==============================================================================
+// container_writer
+//==============================================================================
+template <class dataT>
+inline container_writer<dataT>::container_writer(thread_pool &pool, std::size_t const &block, int const &bits)
+  : pool_(&pool), block_(block), bits_(bits)
+{
+  if (0 == block || block > max_block)
+    throw std::invalid_argument("container_writer: block out of range");
+  if (bits < min_bits || bits > max_bits)
+    throw std::invalid_argument("container_writer: bits out of range");
+}
+
+template <class dataT>
+inline auto container_writer<dataT>::put_header(byte *out) const -> byte* {
+  std::uint32_t const magic   = format::header_magic;
+  std::uint8_t  const head[4] = { format::version, static_cast<std::uint8_t>(arity),
+                                  static_cast<std::uint8_t>(bits_), 0 };
+  std::uint32_t const b32     = static_cast<std::uint32_t>(block_);
+  std::memcpy(out, &magic, sizeof(magic));
+  std::memcpy(out + 4, head, sizeof(head));
+  std::memcpy(out + 8, &b32, sizeof(b32));
+  return out + format::header_size;
+}
+
+template <class dataT>
+inline auto container_writer<dataT>::put_index(std::uint64_t const *off, std::size_t const &n,
+                                               std::size_t const &at, byte *out) const -> byte* {
+  auto const nb = (n + block_ - 1) / block_;
+  for (std::size_t b = 0; b < nb; b++) {
+    std::uint64_t const e[2] = { off[b], b * block_ };
+    std::memcpy(out + b * format::entry_size, e, sizeof(e));
+  }
+
+  auto *const trailer = out + nb * format::entry_size;
+  std::uint64_t const t[3] = { at, nb, n };
+  std::uint32_t const tail = format::trailer_magic;
+  std::memcpy(trailer, t, sizeof(t));
+  std::memcpy(trailer + sizeof(t), &tail, sizeof(tail));
+  return trailer + format::trailer_size;
+}
+
+template <class dataT>
+template <class fnT>
+inline auto container_writer<dataT>::encode(byte const *in, std::size_t const &n, byte *out,
+                                            fnT const &done) const -> std::size_t {
+  auto const nb     = (n + block_ - 1) / block_;
+  auto const slot   = table_size + codec::bound(block_);
+  auto const window = 4 * (pool_->size() + 1);
+
+  internal::vector<byte>          tmp((nb < window ? nb : window) * slot);
+  internal::vector<std::size_t>   len(nb < window ? nb : window);
+  internal::vector<std::uint64_t> off(nb);
+
+  auto *p = put_header(out);
+  for (std::size_t first = 0; first < nb; first += window) {
+    auto const cnt = nb - first < window ? nb - first : window;
+
+    pool_->parallel_for(cnt, [&](std::size_t const &i) {
+      auto const at = (first + i) * block_;
+      auto const m  = at + block_ < n ? block_ : n - at;
+      len[i] = encode_block<dataT>(in + at, m, bits_, tmp.data() + i * slot);
+    });
+
+    // block sizes to offsets, then every block to its offset.
+    auto const total = exclusive_scan(*pool_, len.data(), cnt);
+
+    pool_->parallel_for(cnt, [&](std::size_t const &i) {
+      auto const end = i + 1 < cnt ? len[i + 1] : total;
+      std::memcpy(p + len[i], tmp.data() + i * slot, end - len[i]);
+      off[first + i] = static_cast<std::uint64_t>(p - out) + len[i];
+    });
+
+    p += total;
+    done((first + cnt) * block_ < n ? (first + cnt) * block_ : n, static_cast<std::size_t>(p - out));
+  }
+
+  return static_cast<std::size_t>(put_index(off.data(), n, static_cast<std::size_t>(p - out), p) - out);
+}
+
+//==============================================================================
+// container_reader
+//==============================================================================
+template <class dataT>
+inline container_reader<dataT>::container_reader(byte const *in, std::size_t const &size)
+  : in_(in), index_(nullptr), n_(0), blocks_(0), block_(0), bits_(0), ok_(false)
+{
+  if (size < format::header_size + format::trailer_size)
+    return;
+
+  std::uint32_t magic, tail, b32;
+  std::uint8_t  head[4];
+  std::uint64_t t[3];
+  std::memcpy(&magic, in, sizeof(magic));
+  std::memcpy(head, in + 4, sizeof(head));
+  std::memcpy(&b32, in + 8, sizeof(b32));
+  std::memcpy(t, in + size - format::trailer_size, sizeof(t));
+  std::memcpy(&tail, in + size - format::trailer_size + sizeof(t), sizeof(tail));
+
+  if (format::header_magic != magic || format::trailer_magic != tail)
+    return;
+  if (format::version != head[0] || arity != head[1])
+    return;
+  if (head[2] < container_writer<dataT>::min_bits || head[2] > container_writer<dataT>::max_bits)
+    return;
+  if (0 == b32 || b32 > container_writer<dataT>::max_block)
+    return;
+
+  auto const blocks = t[2] / b32 + (0 != t[2] % b32);
+  if (t[1] != blocks || t[0] < format::header_size || t[0] > size - format::trailer_size
+      || (size - t[0] - format::trailer_size) / format::entry_size != blocks
+      || (size - t[0] - format::trailer_size) % format::entry_size)
+    return;
+
+  // every block lies between the header and the index, after the one before
+  // it and with room for its table, and starts at the symbol its number says.
+  index_ = in + t[0];
+  std::size_t at = format::header_size;
+  for (std::size_t b = 0; b < blocks; b++) {
+    if (entry(b, 0) < at || entry(b, 1) != b * b32)
+      return;
+    at = entry(b, 0) + table_size;
+  }
+  if (at > t[0])
+    return;
+
+  n_      = static_cast<std::size_t>(t[2]);
+  blocks_ = static_cast<std::size_t>(blocks);
+  block_  = b32;
+  bits_   = head[2];
+  ok_     = true;
+}
+
+template <class dataT>
+inline auto container_reader<dataT>::decode_block(std::size_t const &b, byte *out) const -> bool {
+  // a block ends where the next one, or the index, starts.
+  auto const end = b + 1 < blocks_ ? entry(b + 1, 0) : static_cast<std::size_t>(index_ - in_);
+  return core::decode_block<dataT>(in_ + entry(b, 0), end - entry(b, 0), length(b), bits_, out);
+}
+
+template <class dataT>
+inline auto container_reader<dataT>::decode_part(std::size_t const &b, std::size_t const &pos,
+                                                 std::size_t const &len, byte *out) const -> bool {
+  // the part of [pos, pos + len) within block b, straight into out if that is
+  // the whole block.
+  auto const at = offset(b);
+  auto const m  = length(b);
+  auto const lo = pos > at ? pos : at;
+  auto const hi = pos + len < at + m ? pos + len : at + m;
+
+  if (lo == at && hi == at + m)
+    return decode_block(b, out + (at - pos));
+
+  internal::vector<byte> tmp(m);
+  if (!decode_block(b, tmp.data()))
+    return false;
+  std::memcpy(out + (lo - pos), tmp.data() + (lo - at), hi - lo);
+  return true;
+}
+
+template <class dataT>
+inline auto container_reader<dataT>::decode(std::size_t const &pos, std::size_t const &len, byte *out) const -> bool {
+  if (0 == len)
+    return true;
+  for (auto b = block_of(pos); b <= block_of(pos + len - 1); b++)
+    if (!decode_part(b, pos, len, out))
+      return false;
+  return true;
+}
+
+template <class dataT>
+inline auto container_reader<dataT>::decode(thread_pool &pool, std::size_t const &pos,
+                                            std::size_t const &len, byte *out) const -> bool {
+  if (0 == len)
+    return true;
+  auto const first = block_of(pos);
+
+  std::atomic<bool> ok(true);
+  pool.parallel_for(block_of(pos + len - 1) - first + 1, [&](std::size_t const &i) {
+    if (!decode_part(first + i, pos, len, out))
+      ok.store(false, std::memory_order_relaxed);
+  });
+
+  return ok.load(std::memory_order_relaxed);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_CONTAINER_H
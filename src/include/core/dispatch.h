@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_DISPATCH_H
+#define COMP_CORE_DISPATCH_H 1
+
+#include <array>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+# include <cpuid.h>
+#endif
+
+#include "core/internal/isa.h"
+#include "core/types.h"
+
+//------------------------------------------------------------------------------
+// instruction sets known to the dispatcher.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+
+//! instruction sets a kernel can be compiled for, from least to most capable
+enum class isa : int {
+  scalar,
+  avx2,
+  avx512f,
+  avx512dqvl,
+  avx512vbmi2
+};
+
+//! number of instruction sets known to the dispatcher
+static constexpr int isa_count = 5;
+
+//! instruction set of the including translation unit
+static constexpr isa this_isa = isa::COMP_CORE_ISA;
+
+//! widest data type available to the including translation unit
+#if defined(__AVX512F__)
+using native = simd<8>;
+#elif defined(__AVX2__)
+using native = simd<4>;
+#else
+using native = scalar;
+#endif
+
+inline auto isa_name(isa const &i) -> char const* {
+  switch (i) {
+    case isa::scalar:      return "scalar";
+    case isa::avx2:        return "avx2";
+    case isa::avx512f:     return "avx512f";
+    case isa::avx512dqvl:  return "avx512dqvl";
+    case isa::avx512vbmi2: return "avx512vbmi2";
+  }
+  return "unknown";
+}
+
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// host detection.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+inline auto cpuid_isa() -> isa {
+#if defined(COMP_EMU_MARCH)
+  // an emulated march runs anywhere, so the host is whatever it emulates.
+  return isa::COMP_CORE_ISA;
+#elif defined(__x86_64__) || defined(__i386__)
+  unsigned int a, b, c, d;
+
+  if (!__get_cpuid(1, &a, &b, &c, &d))
+    return isa::scalar;
+
+  // the os must save ymm/zmm state across context switches, see xcr0.
+  bool const osxsave = c & (1u << 27);
+  if (!osxsave)
+    return isa::scalar;
+
+  unsigned int xcr0, xcr0_hi;
+  __asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+  (void)xcr0_hi;
+
+  bool const os_ymm = 0x06 == (xcr0 & 0x06);
+  bool const os_zmm = 0xe6 == (xcr0 & 0xe6);
+
+  if (!__get_cpuid_count(7, 0, &a, &b, &c, &d))
+    return isa::scalar;
+
+  bool const avx2     = b & (1u << 5);
+  bool const avx512f  = b & (1u << 16);
+  bool const avx512dq = b & (1u << 17);
+  bool const ifma     = b & (1u << 21);
+  bool const avx512cd = b & (1u << 28);
+  bool const avx512bw = b & (1u << 30);
+  bool const avx512vl = b & (1u << 31);
+  bool const vbmi2    = c & (1u << 6);
+  bool const vpcntdq  = c & (1u << 14);
+
+  // each tier needs every extension comp_dispatch_sources() compiles it with.
+  if (os_zmm && avx512f && avx512cd) {
+    if (avx512dq && avx512vl) {
+      if (avx512bw && vbmi2 && ifma && vpcntdq)
+        return isa::avx512vbmi2;
+      return isa::avx512dqvl;
+    }
+    return isa::avx512f;
+  }
+  if (os_ymm && avx2)
+    return isa::avx2;
+#endif
+  return isa::scalar;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+namespace comp {
+namespace core {
+
+//! Most capable instruction set of the host, probed once.
+inline auto host_isa() -> isa {
+  static isa const host = internal::cpuid_isa();
+  return host;
+}
+
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// dispatcher.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+
+template <class fnT>
+class dispatch;
+
+//! Calls the variant of a kernel compiled for the most capable instruction set
+//! that both has an implementation and is supported by the host.
+template <class retT, class... argT>
+class dispatch<retT(argT...)> {
+  private:
+    using fnT = retT(argT...);
+
+    fnT *fn_;
+    isa  isa_;
+
+  public:
+    // Ctors
+    explicit dispatch(std::array<fnT*, isa_count> const &table) : fn_(nullptr), isa_(isa::scalar) {
+      for (auto i = static_cast<int>(host_isa()); i >= 0; i--) {
+        if (table[i]) {
+          fn_  = table[i];
+          isa_ = static_cast<isa>(i);
+          break;
+        }
+      }
+    }
+
+    auto operator()(argT... args) const -> retT {
+      return fn_(std::forward<argT>(args)...);
+    }
+
+    //! instruction set of the selected variant
+    auto target() const -> isa { return isa_; }
+};
+
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// kernel registration.
+//
+// A kernel is declared once, with its signature, in a header:
+//
+//   COMP_DISPATCH_DECLARE(sum, std::uint64_t(std::uint8_t const *, std::size_t))
+//
+// defined in a source which is compiled once per instruction set (see
+// comp_dispatch_sources() in cmake/CompDispatch.cmake):
+//
+//   template <class dataT> auto sum(std::uint8_t const *, std::size_t) -> std::uint64_t;
+//   COMP_DISPATCH_DEFINE(sum, &sum<comp::core::native>)
+//
+// and called through a dispatcher that is constructed once:
+//
+//   static auto const fn = COMP_DISPATCH(sum);
+//   fn(in, n);
+//------------------------------------------------------------------------------
+#define COMP_DISPATCH_DECLARE(name, ...)                                        \
+  namespace comp_dispatch_ ## name {                                            \
+    using type = __VA_ARGS__;                                                   \
+    extern type *const scalar;                                                  \
+    extern type *const avx2;                                                    \
+    extern type *const avx512f;                                                 \
+    extern type *const avx512dqvl;                                              \
+    extern type *const avx512vbmi2;                                             \
+  }
+
+#if defined(COMP_EMU_MARCH)
+// the emulated march is the only variant that is built, so it defines every
+// entry, and those of the other instruction sets are left empty.
+#define COMP_DISPATCH_DEFINE_emu(i, ...)                                        \
+  type *const i = ::comp::core::isa::i == ::comp::core::this_isa ? __VA_ARGS__ : nullptr;
+#define COMP_DISPATCH_DEFINE(name, ...)                                         \
+  namespace comp_dispatch_ ## name {                                            \
+    COMP_DISPATCH_DEFINE_emu(scalar, __VA_ARGS__)                               \
+    COMP_DISPATCH_DEFINE_emu(avx2, __VA_ARGS__)                                 \
+    COMP_DISPATCH_DEFINE_emu(avx512f, __VA_ARGS__)                              \
+    COMP_DISPATCH_DEFINE_emu(avx512dqvl, __VA_ARGS__)                           \
+    COMP_DISPATCH_DEFINE_emu(avx512vbmi2, __VA_ARGS__)                          \
+  }
+#else
+#define COMP_DISPATCH_DEFINE_impl(name, isa, ...)                               \
+  namespace comp_dispatch_ ## name {                                            \
+    type *const isa = __VA_ARGS__;                                              \
+  }
+#define COMP_DISPATCH_DEFINE_impl_x(name, isa, ...)                             \
+  COMP_DISPATCH_DEFINE_impl(name, isa, __VA_ARGS__)
+#define COMP_DISPATCH_DEFINE(name, ...)                                         \
+  COMP_DISPATCH_DEFINE_impl_x(name, COMP_CORE_ISA, __VA_ARGS__)
+#endif
+
+#define COMP_DISPATCH(name)                                                     \
+  ::comp::core::dispatch<comp_dispatch_ ## name::type>(                         \
+    std::array<comp_dispatch_ ## name::type*, ::comp::core::isa_count>{{        \
+    comp_dispatch_ ## name::scalar,                                             \
+    comp_dispatch_ ## name::avx2,                                               \
+    comp_dispatch_ ## name::avx512f,                                            \
+    comp_dispatch_ ## name::avx512dqvl,                                         \
+    comp_dispatch_ ## name::avx512vbmi2                                         \
+  }})
+
+#endif // COMP_CORE_DISPATCH_H
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_DIVISOR_H
+#define COMP_CORE_DIVISOR_H 1
+
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+
+#include "core/internal/isa.h"
+#include "traits.h"
+
+//------------------------------------------------------------------------------
+// division by invariant integers using multiplication.
+//
+// For a divisor d with l = ceil(log2(d)) the quotient of any unit n is
+//
+//   t = mulhi(m, n),  n / d = (t + ((n - t) >> s1)) >> s2
+//
+// where m = floor(2^w * (2^l - d) / d) + 1, s1 = min(l, 1), s2 = max(l - 1, 0)
+// and w is the width of a unit, see Granlund & Montgomery, PLDI '94.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Precomputed reciprocal of a divisor, laid out to be gathered per lane.
+template <class unitT>
+class reciprocal {
+  static_assert(std::is_unsigned<unitT>::value, "unitT must be unsigned");
+
+  public:
+    static constexpr auto unit_width = static_cast<int>(sizeof(unitT) * CHAR_BIT);
+
+    //! magic multiplier
+    unitT mul;
+    //! s1 in the upper half of the unit, s2 in the lower half
+    unitT shift;
+
+    // Ctors
+    reciprocal() = default;
+    explicit reciprocal(unitT const &d);
+};
+
+template <class unitT>
+inline reciprocal<unitT>::reciprocal(unitT const &d) {
+  int l = 0;
+  while (l < unit_width && (static_cast<unitT>(1) << l) < d)
+    l++;
+
+  if constexpr (64 == unit_width) {
+    using wideT = unsigned __int128;
+    auto const p = (static_cast<wideT>(1) << l) - d;
+    mul = static_cast<unitT>((p << 64) / d + 1);
+  } else {
+    static_assert(32 >= unit_width, "unsupported unit width");
+    using wideT = std::uint64_t;
+    auto const p = (static_cast<wideT>(1) << l) - d;
+    mul = static_cast<unitT>((p << unit_width) / d + 1);
+  }
+
+  unitT const s1 = l < 1 ? l : 1;
+  unitT const s2 = l < 1 ? 0 : l - 1;
+  shift = (s1 << (unit_width / 2)) | s2;
+}
+
+//! Reciprocal of a divisor held in registers, one divisor per lane.
+template <class dataT>
+class divisor {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+
+    static constexpr auto half = data_traits<dataT>::unit_width / 2;
+
+    dataT m_;
+    dataT s1_;
+    dataT s2_;
+
+  public:
+    // Ctors
+    explicit divisor(unitT const &d) : divisor(reciprocal<unitT>(d)) { }
+    explicit divisor(reciprocal<unitT> const &r)
+      : m_(r.mul), s1_(r.shift >> half), s2_(r.shift & ((static_cast<unitT>(1) << half) - 1)) { }
+    divisor(dataT const &mul, dataT const &shift)
+      : m_(mul), s1_(abi::bsr(static_cast<typename abi::base_type>(shift), half)),
+        s2_(abi::land(static_cast<typename abi::base_type>(shift), abi::set((static_cast<unitT>(1) << half) - 1))) { }
+
+    auto mul() const -> dataT const& { return m_; }
+    auto s1() const -> dataT const& { return s1_; }
+    auto s2() const -> dataT const& { return s2_; }
+};
+
+//==============================================================================
+// Binary arithmetic operators
+//==============================================================================
+template <class dataT>
+inline auto operator/(dataT const &a, divisor<dataT> const &d) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::divr(static_cast<base>(a), static_cast<base>(d.mul()),
+                   static_cast<base>(d.s1()), static_cast<base>(d.s2()));
+}
+
+template <class dataT>
+inline auto operator/=(dataT &a, divisor<dataT> const &d) -> dataT& {
+  return (a = a / d);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_DIVISOR_H
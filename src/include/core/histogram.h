@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_HISTOGRAM_H
+#define COMP_CORE_HISTOGRAM_H 1
+
+#include <cstddef>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// symbol histograms.
+//
+// Counting with gather, add, scatter is only correct if no two lanes of a
+// vector touch the same counter. With AVX-512CD each lane adds the number of
+// lower lanes holding the same symbol, and since a scatter writes overlapping
+// lanes from lowest to highest, the highest duplicate stores the full count.
+// Without it every lane counts into its own sub-histogram instead. In both
+// cases consecutive vectors rotate through several tables, so a gather never
+// waits on the scatter just before it.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Add the number of occurrences of each byte of in[0..n) to f, which must
+//! hold at least 256 entries.
+template < class dataT
+         , template <class, class> class contT
+         , class alocT >
+inline auto histogram(byte const *in, std::size_t const &n, contT<freq, alocT> &f) -> void {
+  using abi   = typename data_traits<dataT>::abi;
+  using unitT = typename data_traits<dataT>::unit_type;
+
+  static constexpr auto arity = data_traits<dataT>::arity;
+
+#if defined(__AVX512CD__)
+  static constexpr bool conflict = 1 < arity;
+#else
+  static constexpr bool conflict = false;
+#endif
+
+  static constexpr std::size_t ways  = 4;
+  static constexpr std::size_t lanes = conflict ? 1 : arity;
+  static constexpr std::size_t step  = ways * arity;
+  // a counter gains at most arity per vector, so flushing this often keeps
+  // 32-bit units from wrapping.
+  static constexpr std::size_t chunk = static_cast<std::size_t>(1) << 30;
+
+  internal::vector<unitT> t(ways * lanes * 256);
+
+  auto off = abi::set(0);
+  if constexpr (!conflict) {
+    byte iota[arity];
+    for (int j = 0; j < arity; j++)
+      iota[j] = static_cast<byte>(j);
+    off = abi::bsl(abi::get(iota), 8);
+  }
+  auto const one = abi::set(1);
+
+  std::size_t i = 0;
+  while (n - i >= step) {
+    auto const end = i + (n - i < chunk ? n - i : chunk) / step * step;
+
+    for (; i < end; i += step) {
+      for (std::size_t w = 0; w < ways; w++) {
+        auto *const p = t.data() + w * lanes * 256;
+        auto const  s = abi::add(abi::get(in + i + w * arity), off);
+        auto        c = abi::gather(s, p);
+        if constexpr (conflict)
+          c = abi::add(c, abi::add(abi::cnfl(s), one));
+        else
+          c = abi::add(c, one);
+        abi::scatter(p, s, c);
+      }
+    }
+
+    for (std::size_t j = 0; j < ways * lanes; j++) {
+      for (std::size_t s = 0; s < 256; s++) {
+        f[s] += t[j * 256 + s];
+        t[j * 256 + s] = 0;
+      }
+    }
+  }
+
+  for (; i < n; i++)
+    f[in[i]]++;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_HISTOGRAM_H
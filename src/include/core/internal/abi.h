@@ -2,16 +2,20 @@
 #ifndef COMP_CORE_INTERNAL_ABI_H
 #define COMP_CORE_INTERNAL_ABI_H 1
 
+#include "core/internal/isa.h"
+
 //------------------------------------------------------------------------------
 // internal traits classes.
 //------------------------------------------------------------------------------
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 template <class impl>
 class abi;
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
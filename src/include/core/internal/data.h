@@ -2,15 +2,25 @@
 #ifndef COMP_CORE_INTERNAL_DATA_H
 #define COMP_CORE_INTERNAL_DATA_H 1
 
+#include <type_traits>
+
 #include "core/internal/abi.h"
 #include "core/traits.h"
 
 //------------------------------------------------------------------------------
 // internal data wrapper type.
+//
+// A data value is exactly one vector register. Masked updates go through a
+// where_expression, a view of a value and a mask that only lives until the end
+// of the full expression that created it, e.g. where(k, v) <<= n or v[k] <<= n.
 //------------------------------------------------------------------------------
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+template <class impl>
+class where_expression;
 
 //==============================================================================
 //
@@ -22,17 +32,15 @@ class data {
     using baseT = typename abi<impl>::base_type;
     using maskT = typename abi<impl>::mask_type;
 
-    static constexpr auto arity    = abi<impl>::arity;
-    static constexpr auto mask_max = abi<impl>::mask_max;
+    static constexpr auto arity = abi<impl>::arity;
 
     baseT a_;
-    maskT k_;
 
   public:
     // Ctors
-    data(baseT const &a) : a_(a), k_(mask_max) { }
+    data(baseT const &a) : a_(a) { }
     template<class T1 = unitT, typename T2 = baseT>
-    data(unitT const &a, typename std::enable_if<!std::is_same<T1, T2>::value>::type* = nullptr) : a_(abi<impl>::set(a)), k_(mask_max) { }
+    data(unitT const &a, typename std::enable_if<!std::is_same<T1, T2>::value>::type* = nullptr) : a_(abi<impl>::set(a)) { }
 
     // Type conversion
     explicit operator baseT const&() const { return a_; }
@@ -41,9 +49,43 @@ class data {
     auto operator<<=(int const &imm8) -> data<impl>&;
 
     // Mask operators
-    auto operator[](maskT const &k) -> data<impl>&;
+    //! Masked view of this value, same as where(k, *this).
+    auto operator[](maskT const &k) -> where_expression<impl>;
+};
+
+//==============================================================================
+//
+//==============================================================================
+template <class impl>
+class where_expression {
+  private:
+    using baseT = typename abi<impl>::base_type;
+    using maskT = typename abi<impl>::mask_type;
+
+    maskT const k_;
+    data<impl> &v_;
+
+  public:
+    // Ctors
+    where_expression(maskT const &k, data<impl> &v) : k_(k), v_(v) { }
+    where_expression(where_expression const &) = delete;
+    auto operator=(where_expression const &) -> where_expression& = delete;
+
+    // Binary arithmetic operators
+    auto operator--(int) && -> data<impl>&;
+    auto operator+=(data<impl> const &b) && -> data<impl>&;
+    auto operator-=(data<impl> const &b) && -> data<impl>&;
+    auto operator*=(data<impl> const &b) && -> data<impl>&;
+    auto operator/=(data<impl> const &b) && -> data<impl>&;
+
+    // Bitwise arithmetic operators
+    auto operator|=(data<impl> const &b) && -> data<impl>&;
+    auto operator^=(data<impl> const &b) && -> data<impl>&;
+    auto operator<<=(int const &imm8) && -> data<impl>&;
+    auto operator>>=(int const &imm8) && -> data<impl>&;
 };
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
@@ -54,6 +96,7 @@ class data {
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 //==============================================================================
 // Unary arithmetic operators
@@ -117,6 +160,13 @@ inline auto operator+=(dataT &a, dataT const &b) -> dataT& {
   return (a = abi::add(static_cast<base>(a), static_cast<base>(b)));
 }
 
+template <class dataT>
+inline auto operator-=(dataT &a, dataT const &b) -> dataT& {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return (a = abi::sub(static_cast<base>(a), static_cast<base>(b)));
+}
+
 template <class dataT>
 inline auto operator*=(dataT &a, dataT const &b) -> dataT& {
   using abi  = typename data_traits<dataT>::abi;
@@ -131,6 +181,31 @@ inline auto operator/=(dataT &a, dataT const &b) -> dataT& {
   return (a = abi::div(static_cast<base>(a), static_cast<base>(b)));
 }
 
+template <class impl>
+inline auto where_expression<impl>::operator--(int) && -> data<impl>& {
+  return (v_ = abi<impl>::msub(k_, static_cast<baseT>(v_), abi<impl>::set(1)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator+=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::madd(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator-=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::msub(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator*=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::mmul(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator/=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::mdiv(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
 //==============================================================================
 // Bitwise arithmetic operators
 //==============================================================================
@@ -155,6 +230,13 @@ inline auto operator|=(dataT &a, dataT const &b) -> dataT& {
   return (a = abi::lor(static_cast<base>(a), static_cast<base>(b)));
 }
 
+template <class dataT>
+inline auto operator^=(dataT &a, dataT const &b) -> dataT& {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return (a = abi::eor(static_cast<base>(a), static_cast<base>(b)));
+}
+
 template <class dataT>
 inline auto operator>>=(dataT &a, int const &imm8) -> dataT& {
   using abi  = typename data_traits<dataT>::abi;
@@ -164,15 +246,75 @@ inline auto operator>>=(dataT &a, int const &imm8) -> dataT& {
 
 template <class impl>
 inline auto data<impl>::operator<<=(int const &imm8) -> data<impl>& {
-  if (mask_max == k_) {
-    a_ = abi<impl>::bsl(a_, imm8);
-  } else {
-    a_ = abi<impl>::mbsl(k_, a_, imm8);
-    k_ = mask_max;
-  }
+  a_ = abi<impl>::bsl(a_, imm8);
   return *this;
 }
 
+template <class impl>
+inline auto where_expression<impl>::operator|=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::mlor(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator^=(data<impl> const &b) && -> data<impl>& {
+  return (v_ = abi<impl>::meor(k_, static_cast<baseT>(v_), static_cast<baseT>(b)));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator<<=(int const &imm8) && -> data<impl>& {
+  return (v_ = abi<impl>::mbsl(k_, static_cast<baseT>(v_), imm8));
+}
+
+template <class impl>
+inline auto where_expression<impl>::operator>>=(int const &imm8) && -> data<impl>& {
+  return (v_ = abi<impl>::mbsr(k_, static_cast<baseT>(v_), imm8));
+}
+
+//==============================================================================
+// Fused arithmetic
+//==============================================================================
+//! Quotient and remainder of a division, one per lane.
+template <class dataT>
+struct div_result {
+  dataT quot;
+  dataT rem;
+};
+
+//! a * b + c, modulo the unit width.
+template <class dataT>
+inline auto muladd(dataT const &a, dataT const &b, dataT const &c) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::muladd(static_cast<base>(a), static_cast<base>(b), static_cast<base>(c));
+}
+
+//! a * b + c for a, b < 2^32 and a * b < 2^52, in one instruction with
+//! AVX-512IFMA.
+template <class dataT>
+inline auto muladd52(dataT const &a, dataT const &b, dataT const &c) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::muladd52(static_cast<base>(a), static_cast<base>(b), static_cast<base>(c));
+}
+
+//! a / b and a % b together.
+template <class dataT>
+inline auto divmod(dataT const &a, dataT const &b) -> div_result<dataT> {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  base r;
+  auto const q = abi::divmod(static_cast<base>(a), static_cast<base>(b), r);
+  return { dataT(q), dataT(r) };
+}
+
+//! (a >> imm8) & m, e.g. to extract a field of packed lanes.
+template <class dataT>
+inline auto bsrm(dataT const &a, int const &imm8, dataT const &m) -> dataT {
+  using abi  = typename data_traits<dataT>::abi;
+  using base = typename data_traits<dataT>::base_type;
+  return abi::bsrm(static_cast<base>(a), imm8, static_cast<base>(m));
+}
+
 //==============================================================================
 // Relational operators
 //==============================================================================
@@ -213,11 +355,17 @@ inline auto operator!=(dataT const &a, dataT const &b) -> maskT {
 // Mask operators
 //==============================================================================
 template <class impl>
-inline auto data<impl>::operator[](maskT const &k) -> data<impl>& {
-  k_ = k;
-  return *this;
+inline auto data<impl>::operator[](maskT const &k) -> where_expression<impl> {
+  return where_expression<impl>(k, *this);
+}
+
+//! Masked view of v, whose compound assignments only update the lanes of k.
+template <class impl>
+inline auto where(typename abi<impl>::mask_type const &k, data<impl> &v) -> where_expression<impl> {
+  return where_expression<impl>(k, v);
 }
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
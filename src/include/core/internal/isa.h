@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_INTERNAL_ISA_H
+#define COMP_CORE_INTERNAL_ISA_H 1
+
+//------------------------------------------------------------------------------
+// enable architecture emulation -- if requested. The emulator defines the
+// feature macros of the march, so it must come before they are tested.
+//------------------------------------------------------------------------------
+#if defined(COMP_EMU_MARCH)
+# include "core/internal/simd/emu.h"
+#endif
+
+//------------------------------------------------------------------------------
+// instruction set the including translation unit is compiled for.
+//------------------------------------------------------------------------------
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__) \
+ && defined(__AVX512BW__) && defined(__AVX512VBMI2__)
+# define COMP_CORE_ISA avx512vbmi2
+#elif defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+# define COMP_CORE_ISA avx512dqvl
+#elif defined(__AVX512F__)
+# define COMP_CORE_ISA avx512f
+#elif defined(__AVX2__)
+# define COMP_CORE_ISA avx2
+#else
+# define COMP_CORE_ISA scalar
+#endif
+
+//------------------------------------------------------------------------------
+// everything in comp::core and comp::core::internal lives in an inline
+// namespace named after the instruction set, so translation units built with
+// different -m flags can be linked into one binary without their inline
+// functions being merged. Only the dispatcher in dispatch.h, which every
+// variant must share, and the type aliases and traits, which emit no code,
+// stay outside.
+//
+// Inline functions and templates from anywhere else, the standard library
+// included, are still emitted once per translation unit and merged by the
+// linker, which keeps the first copy it sees; comp_dispatch_sources() links
+// the scalar objects first, and without link time optimization, so that the
+// copy kept runs on any host.
+//------------------------------------------------------------------------------
+#define COMP_CORE_ISA_NAMESPACE_impl_x(a) isa_ ## a
+#define COMP_CORE_ISA_NAMESPACE_impl(a)   COMP_CORE_ISA_NAMESPACE_impl_x(a)
+#define COMP_CORE_ISA_NAMESPACE           COMP_CORE_ISA_NAMESPACE_impl(COMP_CORE_ISA)
+
+#endif // COMP_CORE_INTERNAL_ISA_H
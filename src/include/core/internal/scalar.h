@@ -3,6 +3,7 @@
 #define COMP_CORE_INTERNAL_SCALAR_H 1
 
 #include <climits>
+#include <cstring>
 #include <limits>
 
 #include "core/internal/abi.h"
@@ -13,6 +14,7 @@
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 class scalar {
   public:
@@ -21,6 +23,7 @@ class scalar {
     using maskT = bool;
 };
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
@@ -31,6 +34,7 @@ class scalar {
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 template <>
 class abi<scalar> {
@@ -50,6 +54,9 @@ class abi<scalar> {
     static constexpr auto mask_max = true;
 
     static constexpr auto unit_width = static_cast<int>(sizeof(unitT) * CHAR_BIT);
+    //! bytes from its address that mget() may read, all of which must be
+    //! readable
+    static constexpr auto mget_span = 1;
 
     static auto set(unitT const &a) -> baseT {
       return a;
@@ -72,6 +79,50 @@ class abi<scalar> {
     static auto cpy(void *base_addr, baseT const &a) -> void {
       *static_cast<baseT*>(base_addr) = a;
     }
+    static auto lod(void const *mem_addr) -> baseT {
+      return *static_cast<baseT const*>(mem_addr);
+    }
+    static auto mcpy(void *base_addr, maskT const &k, baseT const &a) -> void {
+      if (k)
+        *static_cast<baseT*>(base_addr) = a;
+    }
+    static auto mlod(maskT const &k, void const *mem_addr) -> baseT {
+      return k ? *static_cast<baseT const*>(mem_addr) : 0;
+    }
+
+    static auto get16(void const *mem_addr) -> baseT {
+      std::uint16_t a;
+      std::memcpy(&a, mem_addr, sizeof(a));
+      return a;
+    }
+    static auto put16(void *base_addr, baseT const &a) -> void {
+      auto const b = static_cast<std::uint16_t>(a);
+      std::memcpy(base_addr, &b, sizeof(b));
+    }
+    static auto get32(void const *mem_addr) -> baseT {
+      std::uint32_t a;
+      std::memcpy(&a, mem_addr, sizeof(a));
+      return a;
+    }
+    static auto put32(void *base_addr, baseT const &a) -> void {
+      auto const b = static_cast<std::uint32_t>(a);
+      std::memcpy(base_addr, &b, sizeof(b));
+    }
+
+    static auto mget16(maskT const &k, void const *mem_addr) -> baseT {
+      return k ? get16(mem_addr) : 0;
+    }
+    static auto mput16(void *base_addr, maskT const &k, baseT const &a) -> void {
+      if (k)
+        put16(base_addr, a);
+    }
+    static auto mget32(maskT const &k, void const *mem_addr) -> baseT {
+      return k ? get32(mem_addr) : 0;
+    }
+    static auto mput32(void *base_addr, maskT const &k, baseT const &a) -> void {
+      if (k)
+        put32(base_addr, a);
+    }
 
     static auto gather(baseT const &vindex, void const *base_addr) -> baseT {
       return static_cast<baseT const*>(base_addr)[vindex];
@@ -79,21 +130,73 @@ class abi<scalar> {
     static auto scatter(void *base_addr, baseT const &vindex, baseT const &a) -> void {
       static_cast<baseT*>(base_addr)[vindex] = a;
     }
+    static auto mgather(maskT const &k, baseT const &vindex, void const *base_addr) -> baseT {
+      return k ? static_cast<baseT const*>(base_addr)[vindex] : 0;
+    }
+    static auto mscatter(void *base_addr, maskT const &k, baseT const &vindex, baseT const &a) -> void {
+      if (k)
+        static_cast<baseT*>(base_addr)[vindex] = a;
+    }
 
     static auto neg(baseT const &a) -> baseT { return -a; }
     static auto add(baseT const &a, baseT const & b) -> baseT { return a + b; }
     static auto mul(baseT const &a, baseT const & b) -> baseT { return a * b; }
     static auto sub(baseT const &a, baseT const & b) -> baseT { return a - b; }
     static auto div(baseT const &a, baseT const & b) -> baseT { return a / b; }
+    static auto land(baseT const &a, baseT const & b) -> baseT { return a & b; }
     static auto lor(baseT const &a, baseT const & b) -> baseT { return a | b; }
     static auto eor(baseT const &a, baseT const & b) -> baseT { return a ^ b; }
 
+    static auto madd(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a + b : a; }
+    static auto msub(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a - b : a; }
+    static auto mmul(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a * b : a; }
+    static auto mdiv(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a / b : a; }
+    static auto mlor(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a | b : a; }
+    static auto meor(maskT const &k, baseT const &a, baseT const &b) -> baseT { return k ? a ^ b : a; }
+
     static auto bsl(baseT const &a, unsigned int const &imm8) -> baseT { return a << imm8; }
     static auto bsr(baseT const &a, unsigned int const &imm8) -> baseT { return a >> imm8; }
 
+    static auto bsrv(baseT const &a, baseT const &count) -> baseT {
+      return count < unit_width ? a >> count : 0;
+    }
+    static auto bsrm(baseT const &a, unsigned int const &imm8, baseT const &m) -> baseT {
+      return (a >> imm8) & m;
+    }
+
+    static auto muladd(baseT const &a, baseT const &b, baseT const &c) -> baseT { return a * b + c; }
+    static auto muladd52(baseT const &a, baseT const &b, baseT const &c) -> baseT { return a * b + c; }
+    static auto divmod(baseT const &a, baseT const &b, baseT &r) -> baseT {
+      r = a % b;
+      return a / b;
+    }
+
+    static auto mulhi(baseT const &a, baseT const &b) -> baseT {
+      return static_cast<baseT>((static_cast<unsigned __int128>(a) * b) >> unit_width);
+    }
+    static auto divr(baseT const &a, baseT const &m, baseT const &s1, baseT const &s2) -> baseT {
+      auto const t = mulhi(m, a);
+      return (t + ((a - t) >> s1)) >> s2;
+    }
+
     static auto mbsl(maskT const& k, baseT const &a, unsigned int const &imm8) -> baseT {
       return a << (k ? imm8 : 0);
     }
+    static auto mbsr(maskT const& k, baseT const &a, unsigned int const &imm8) -> baseT {
+      return a >> (k ? imm8 : 0);
+    }
+
+    static auto hadd(baseT const &a) -> unitT { return a; }
+    static auto hmin(baseT const &a) -> unitT { return a; }
+    static auto hmax(baseT const &a) -> unitT { return a; }
+    static auto hlor(baseT const &a) -> unitT { return a; }
+    static auto heor(baseT const &a) -> unitT { return a; }
+
+    static auto iscan(baseT const &a) -> baseT { return a; }
+    static auto escan(baseT const &)  -> baseT { return 0; }
+
+    static auto perm(baseT const &a, baseT const &) -> baseT { return a; }
+    static auto bcst(baseT const &a, unsigned int const &) -> baseT { return a; }
 
     static auto mcnt(maskT const &k) -> int { return k ? 1 : 0; }
 
@@ -103,6 +206,7 @@ class abi<scalar> {
     static auto cmpne(baseT const &a, baseT const &b) -> maskT { return a != b; }
 };
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
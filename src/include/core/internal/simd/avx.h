@@ -4,12 +4,15 @@
 
 #include <climits>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 
 #ifndef COMP_EMU_MARCH_AVX
 # include <immintrin.h>
 #endif
 
+#include "core/internal/abi.h"
+
 #define HAS_SIMD_INSTRUCTIONS
 
 //------------------------------------------------------------------------------
@@ -25,11 +28,26 @@
 #else
 # define pp_vlext 0
 #endif
-#if defined(__AVX512_VBMI2__)
+#if defined(__AVX512VBMI2__)
 # define pp_vbmi2 1
 #else
 # define pp_vbmi2 0
 #endif
+#if defined(__AVX512CD__)
+# define pp_cnfl 1
+#else
+# define pp_cnfl 0
+#endif
+#if defined(__AVX512VPOPCNTDQ__)
+# define pp_vpcnt 1
+#else
+# define pp_vpcnt 0
+#endif
+#if defined(__AVX512IFMA__)
+# define pp_ifma 1
+#else
+# define pp_ifma 0
+#endif
 
 //------------------------------------------------------------------------------
 // internal::simd::avx<> type.
@@ -37,6 +55,7 @@
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 namespace simd {
 
 template <int arity>
@@ -69,7 +88,18 @@ class avx<8> {
     static constexpr maskT mask_max = 0xff;
 };
 
+template <>
+class avx<16> {
+  public:
+    using baseT = __m512i;
+    using maskT = __mmask16;
+    using unitT = std::uint32_t;
+
+    static constexpr maskT mask_max = 0xffff;
+};
+
 } // namespace simd
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
@@ -80,6 +110,7 @@ class avx<8> {
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 template <int ARITY>
 class abi<simd::avx<ARITY>> {
@@ -88,6 +119,11 @@ class abi<simd::avx<ARITY>> {
     using baseT = typename simd::avx<ARITY>::baseT;
     using maskT = typename simd::avx<ARITY>::maskT;
 
+    static auto mulu32(baseT const &a, baseT const &b) -> baseT;
+    static auto spread(maskT const &k) -> __mmask16;
+    static auto loadn(void const *mem_addr, unsigned int const &n) -> __m512i;
+    static auto divmod52(baseT const &a, baseT const &b, baseT &r) -> baseT;
+
   public:
     using unit_type = unitT;
     using base_type = baseT;
@@ -99,17 +135,39 @@ class abi<simd::avx<ARITY>> {
     static constexpr auto mask_max = simd::avx<ARITY>::mask_max;
 
     static constexpr auto unit_width = static_cast<int>(sizeof(unitT) * CHAR_BIT);
+    //! bytes from its address that mget() may read, all of which must be
+    //! readable; without VBMI2 it loads a whole XMM register.
+#if pp_vbmi2
+    static constexpr auto mget_span = ARITY;
+#else
+    static constexpr auto mget_span = 16;
+#endif
 
     static auto set(const unitT &a) -> baseT;
     static auto get(void const *a) -> baseT;
     static auto put(void *base_addr, baseT const& a) -> void;
     static auto cpy(void *base_addr, baseT const& a) -> void;
+    static auto lod(void const *mem_addr) -> baseT;
 
     static auto mget(maskT const &k, void const *mem_addr) -> baseT;
     static auto mput(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mcpy(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mlod(maskT const &k, void const *mem_addr) -> baseT;
+
+    static auto get16(void const *mem_addr) -> baseT;
+    static auto put16(void *base_addr, baseT const &a) -> void;
+    static auto get32(void const *mem_addr) -> baseT;
+    static auto put32(void *base_addr, baseT const &a) -> void;
+
+    static auto mget16(maskT const &k, void const *mem_addr) -> baseT;
+    static auto mput16(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mget32(maskT const &k, void const *mem_addr) -> baseT;
+    static auto mput32(void *base_addr, maskT const &k, baseT const &a) -> void;
 
     static auto gather(baseT const &vindex, void const *base_addr) -> baseT;
     static auto scatter(void *base_addr, baseT const &vindex, baseT const &a) -> void;
+    static auto mgather(maskT const &k, baseT const &vindex, void const *base_addr) -> baseT;
+    static auto mscatter(void *base_addr, maskT const &k, baseT const &vindex, baseT const &a) -> void;
 
     static auto neg(baseT const &a) -> baseT;
 
@@ -118,22 +176,59 @@ class abi<simd::avx<ARITY>> {
     static auto mul(baseT const &a, baseT const &b) -> baseT;
     static auto div(baseT const &a, baseT const &b) -> baseT;
 
+    static auto madd(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto msub(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto mmul(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto mdiv(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+
+    static auto mulhi(baseT const &a, baseT const &b) -> baseT;
+    static auto divr(baseT const &a, baseT const &m, baseT const &s1, baseT const &s2) -> baseT;
+
+    static auto muladd(baseT const &a, baseT const &b, baseT const &c) -> baseT;
+    static auto muladd52(baseT const &a, baseT const &b, baseT const &c) -> baseT;
+    static auto divmod(baseT const &a, baseT const &b, baseT &r) -> baseT;
+
     static auto bsr(baseT const &a, unsigned int const &imm8) -> baseT;
     static auto bsl(baseT const &a, unsigned int const &imm8) -> baseT;
 
+    static auto bsrv(baseT const &a, baseT const &count) -> baseT;
+    static auto bsrm(baseT const &a, unsigned int const &imm8, baseT const &m) -> baseT;
+
     static auto mbsl(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT;
+    static auto mbsr(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT;
 
+    static auto land(baseT const &a, baseT const &b) -> baseT;
     static auto lor(baseT const &a, baseT const &b) -> baseT;
     static auto eor(baseT const &a, baseT const &b) -> baseT;
 
+    static auto mlor(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto meor(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+
+    static auto hadd(baseT const &a) -> unitT;
+    static auto hmin(baseT const &a) -> unitT;
+    static auto hmax(baseT const &a) -> unitT;
+    static auto hlor(baseT const &a) -> unitT;
+    static auto heor(baseT const &a) -> unitT;
+
+    static auto iscan(baseT const &a) -> baseT;
+    static auto escan(baseT const &a) -> baseT;
+
+    static auto perm(baseT const &a, baseT const &idx) -> baseT;
+    static auto bcst(baseT const &a, unsigned int const &lane) -> baseT;
+
     static auto mcnt(maskT const &k) -> int;
 
     static auto cmpgt(baseT const &a, baseT const &b) -> maskT;
     static auto cmple(baseT const &a, baseT const &b) -> maskT;
     static auto cmpeq(baseT const &a, baseT const &b) -> maskT;
     static auto cmpne(baseT const &a, baseT const &b) -> maskT;
+
+#if pp_cnfl
+    static auto cnfl(baseT const &a) -> baseT;
+#endif
 };
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
@@ -144,6 +239,7 @@ class abi<simd::avx<ARITY>> {
 namespace comp {
 namespace core {
 namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
 
 template <int arity>
 inline auto abi<simd::avx<arity>>::set(unitT const& a) -> baseT {
@@ -155,6 +251,8 @@ inline auto abi<simd::avx<arity>>::set(unitT const& a) -> baseT {
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_set_epi64(a, a, a, a, a, a, a, a);
+  } else if constexpr (16 == arity) {
+    return _mm512_set1_epi32(a);
   }
 }
 
@@ -177,23 +275,23 @@ inline auto abi<simd::avx<arity>>::get(void const *mem_addr) -> baseT {
         return _mm512_cvtepu8_epi64(
           _mm512_castsi512_si128(_mm512_maskz_expandloadu_epi8(mask_max, mem_addr)));
 #     endif
+    } else if constexpr (16 == arity) {
+      return _mm512_cvtepu8_epi32(_mm_loadu_si128(static_cast<__m128i const*>(mem_addr)));
     }
 # endif
 
-  unsigned char ap[16] = { 0 };
-  auto const *m = static_cast<unsigned char const*>(mem_addr);
-  for (int j = 0; j < arity; j++)
-    ap[j] = m[j];
-  auto const b = _mm_loadu_si128(reinterpret_cast<__m128i*>(ap));
-
   if constexpr (4 == arity) {
+    std::uint32_t w;
+    std::memcpy(&w, mem_addr, sizeof(w));
 #   if pp_qword && pp_vlext
-      return _mm256_cvtepu8_epi64(b);
+      return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(w));
 #   else
-      return _mm512_maskz_cvtepu8_epi64(mask_max, b);
+      return _mm512_maskz_cvtepu8_epi64(mask_max, _mm_cvtsi32_si128(w));
 #   endif
   } else if constexpr (8 == arity) {
-    return _mm512_cvtepu8_epi64(b);
+    return _mm512_cvtepu8_epi64(_mm_loadl_epi64(static_cast<__m128i const*>(mem_addr)));
+  } else if constexpr (16 == arity) {
+    return _mm512_cvtepu8_epi32(_mm_loadu_si128(static_cast<__m128i const*>(mem_addr)));
   }
 }
 
@@ -201,12 +299,14 @@ template <int arity>
 inline auto abi<simd::avx<arity>>::put(void *base_addr, baseT const& a) -> void {
   if constexpr (4 == arity) {
 #   if pp_qword && pp_vlext
-      _mm256_cvtepi64_storeu_epi8(base_addr, a);
+      _mm256_mask_cvtepi64_storeu_epi8(base_addr, mask_max, a);
 #   else
       _mm512_mask_cvtepi64_storeu_epi8(base_addr, mask_max, a);
 #   endif
   } else if constexpr (8 == arity) {
-    _mm512_cvtepi64_storeu_epi8(base_addr, a);
+    _mm512_mask_cvtepi64_storeu_epi8(base_addr, mask_max, a);
+  } else if constexpr (16 == arity) {
+    _mm512_mask_cvtepi32_storeu_epi8(base_addr, mask_max, a);
   }
 }
 
@@ -220,6 +320,53 @@ inline auto abi<simd::avx<arity>>::cpy(void *base_addr, baseT const& a) -> void
 #   endif
   } else if constexpr (8 == arity) {
     _mm512_storeu_epi64(base_addr, a);
+  } else if constexpr (16 == arity) {
+    _mm512_storeu_epi32(base_addr, a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::lod(void const *mem_addr) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_loadu_si256(static_cast<__m256i const*>(mem_addr));
+#   else
+      return _mm512_maskz_loadu_epi64(mask_max, mem_addr);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_loadu_si512(mem_addr);
+  } else if constexpr (16 == arity) {
+    return _mm512_loadu_si512(mem_addr);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mcpy(void *base_addr, maskT const &k, baseT const &a) -> void {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_storeu_epi64(base_addr, k, a);
+#   else
+      _mm512_mask_storeu_epi64(base_addr, k & mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_storeu_epi64(base_addr, k, a);
+  } else if constexpr (16 == arity) {
+    _mm512_mask_storeu_epi32(base_addr, k, a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mlod(maskT const &k, void const *mem_addr) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_maskz_loadu_epi64(k, mem_addr);
+#   else
+      return _mm512_maskz_loadu_epi64(k & mask_max, mem_addr);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_maskz_loadu_epi64(k, mem_addr);
+  } else if constexpr (16 == arity) {
+    return _mm512_maskz_loadu_epi32(k, mem_addr);
   }
 }
 
@@ -239,25 +386,33 @@ inline auto abi<simd::avx<arity>>::mget(maskT const &k, void const *mem_addr) ->
 #     else
         return _mm512_cvtepu8_epi64(
           _mm512_castsi512_si128(_mm512_maskz_expandloadu_epi8(k, mem_addr)));
+#     endif
+    } else if constexpr (16 == arity) {
+#     if pp_vlext
+        return _mm512_cvtepu8_epi32(_mm_maskz_expandloadu_epi8(k, mem_addr));
+#     else
+        return _mm512_cvtepu8_epi32(
+          _mm512_castsi512_si128(_mm512_maskz_expandloadu_epi8(k, mem_addr)));
 #     endif
     }
 # endif
 
-  unsigned char ap[16] = { 0 };
-  auto const *m = static_cast<unsigned char const*>(mem_addr);
-  for (int j = 0; j < arity; j++)
-    if (k & (1 << j))
-      ap[j] = *m++;
-  auto const b = _mm_loadu_si128(reinterpret_cast<__m128i*>(ap));
+  // the mcnt(k) bytes are widened in order and expanded into the lanes of k.
+  // the load takes all mget_span bytes, which the caller keeps readable, as
+  // byte masks need AVX512BW and loading exactly what is needed costs a
+  // dependent branch per read.
+  auto const b = _mm_loadu_si128(static_cast<__m128i const*>(mem_addr));
 
   if constexpr (4 == arity) {
 #   if pp_qword && pp_vlext
-      return _mm256_cvtepu8_epi64(b);
+      return _mm256_maskz_expand_epi64(k, _mm256_cvtepu8_epi64(b));
 #   else
-      return _mm512_maskz_cvtepu8_epi64(mask_max, b);
+      return _mm512_maskz_expand_epi64(k & mask_max, _mm512_cvtepu8_epi64(b));
 #   endif
   } else if constexpr (8 == arity) {
-    return _mm512_cvtepu8_epi64(b);
+    return _mm512_maskz_expand_epi64(k, _mm512_cvtepu8_epi64(b));
+  } else if constexpr (16 == arity) {
+    return _mm512_maskz_expand_epi32(k, _mm512_cvtepu8_epi32(b));
   }
 }
 
@@ -277,45 +432,208 @@ inline auto abi<simd::avx<arity>>::mput(void *base_addr, maskT const &k, baseT c
 #     else
         _mm512_mask_compressstoreu_epi8(base_addr, k,
             _mm512_castsi128_si512(_mm512_cvtepi64_epi8(a)));
+#     endif
+    } else if constexpr (16 == arity) {
+#     if pp_vlext
+        _mm_mask_compressstoreu_epi8(base_addr, k, _mm512_cvtepi32_epi8(a));
+#     else
+        _mm512_mask_compressstoreu_epi8(base_addr, k,
+            _mm512_castsi128_si512(_mm512_cvtepi32_epi8(a)));
 #     endif
     }
 # else
-    __m128i b;
-    unsigned char ap[16];
-    auto *m = static_cast<unsigned char*>(base_addr);
-
-    for (int j = 0; j < arity; j++)
-      if (k & (1 << j))
-        *m++ = ap[j];
+    // compress the lanes of k to the bottom and narrow exactly mcnt(k) of them.
+    auto const n = static_cast<unsigned int>(mcnt(k));
 
     if constexpr (4 == arity) {
 #     if pp_qword && pp_vlext
-        b = _mm256_cvtepi64_epi8(a);
+        _mm256_mask_cvtepi64_storeu_epi8(base_addr, (1u << n) - 1, _mm256_maskz_compress_epi64(k, a));
 #     else
-        b = _mm512_maskz_cvtepi64_epi8(mask_max, a);
+        _mm512_mask_cvtepi64_storeu_epi8(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi64(k & mask_max, a));
 #     endif
     } else if constexpr (8 == arity) {
-#     if pp_vlext
-        b = _mm512_cvtepi64_epi8(a);
+      _mm512_mask_cvtepi64_storeu_epi8(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi64(k, a));
+    } else if constexpr (16 == arity) {
+      _mm512_mask_cvtepi32_storeu_epi8(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi32(k, a));
+    }
+# endif
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::loadn(void const *mem_addr, unsigned int const &n) -> __m512i {
+  // exactly the n <= 32 bytes at mem_addr, zero-extended: the whole dwords
+  // through a masked load, which does not fault on the dwords it skips, and
+  // the last n % 4 bytes into the dword after them.
+  auto const *m = static_cast<unsigned char const*>(mem_addr);
+  auto const  d = n >> 2;
+
+  std::uint32_t w = 0;
+  if (n & 2) {
+    std::uint16_t h;
+    std::memcpy(&h, m + 4 * d, sizeof(h));
+    w = h;
+  }
+  if (n & 1)
+    w |= static_cast<std::uint32_t>(m[n - 1]) << (8 * (n & 2));
+
+  auto const b = _mm512_maskz_loadu_epi32(static_cast<__mmask16>((1u << d) - 1), m);
+  return _mm512_mask_set1_epi32(b, static_cast<__mmask16>(1u << d), static_cast<int>(w));
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::spread(maskT const &k) -> __mmask16 {
+  // bit i of k to bit 2i, i.e., from a quadword lane to its low dword.
+  unsigned int x = k;
+  x = (x | (x << 4)) & 0x0f0f;
+  x = (x | (x << 2)) & 0x3333;
+  x = (x | (x << 1)) & 0x5555;
+  return static_cast<__mmask16>(x);
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::get16(void const *mem_addr) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_cvtepu16_epi64(_mm_loadl_epi64(static_cast<__m128i const*>(mem_addr)));
+#   else
+      return _mm512_maskz_cvtepu16_epi64(mask_max, _mm_loadl_epi64(static_cast<__m128i const*>(mem_addr)));
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_cvtepu16_epi64(_mm_loadu_si128(static_cast<__m128i const*>(mem_addr)));
+  } else if constexpr (16 == arity) {
+    return _mm512_cvtepu16_epi32(_mm256_loadu_si256(static_cast<__m256i const*>(mem_addr)));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::put16(void *base_addr, baseT const &a) -> void {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_cvtepi64_storeu_epi16(base_addr, mask_max, a);
+#   else
+      _mm512_mask_cvtepi64_storeu_epi16(base_addr, mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_cvtepi64_storeu_epi16(base_addr, mask_max, a);
+  } else if constexpr (16 == arity) {
+    _mm512_mask_cvtepi32_storeu_epi16(base_addr, mask_max, a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::get32(void const *mem_addr) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_cvtepu32_epi64(_mm_loadu_si128(static_cast<__m128i const*>(mem_addr)));
+#   else
+      return _mm512_cvtepu32_epi64(_mm512_castsi512_si256(_mm512_maskz_loadu_epi32(0xf, mem_addr)));
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_cvtepu32_epi64(_mm256_loadu_si256(static_cast<__m256i const*>(mem_addr)));
+  } else if constexpr (16 == arity) {
+    return lod(mem_addr);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::put32(void *base_addr, baseT const &a) -> void {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_cvtepi64_storeu_epi32(base_addr, mask_max, a);
+#   else
+      _mm512_mask_cvtepi64_storeu_epi32(base_addr, mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_cvtepi64_storeu_epi32(base_addr, mask_max, a);
+  } else if constexpr (16 == arity) {
+    cpy(base_addr, a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mget16(maskT const &k, void const *mem_addr) -> baseT {
+  // as mget, the 2 * mcnt(k) bytes are widened in order and expanded into the
+  // lanes of k, though only those bytes are loaded.
+  auto const v = loadn(mem_addr, 2 * static_cast<unsigned int>(mcnt(k)));
+
+  if constexpr (16 == arity) {
+    return _mm512_maskz_expand_epi32(k, _mm512_cvtepu16_epi32(_mm512_castsi512_si256(v)));
+  } else {
+    auto const b = _mm512_castsi512_si128(v);
+
+    if constexpr (4 == arity) {
+#     if pp_qword && pp_vlext
+        return _mm256_maskz_expand_epi64(k, _mm256_cvtepu16_epi64(b));
 #     else
-        b = _mm512_maskz_cvtepi64_epi8(mask_max, a);
+        return _mm512_maskz_expand_epi64(k & mask_max, _mm512_cvtepu16_epi64(b));
 #     endif
+    } else {
+      return _mm512_maskz_expand_epi64(k, _mm512_cvtepu16_epi64(b));
     }
-    _mm_storeu_si128(reinterpret_cast<__m128i*>(ap), b);
-# endif
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mput16(void *base_addr, maskT const &k, baseT const &a) -> void {
+  // compress the lanes of k to the bottom and narrow exactly mcnt(k) of them.
+  auto const n = static_cast<unsigned int>(mcnt(k));
+
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_cvtepi64_storeu_epi16(base_addr, (1u << n) - 1, _mm256_maskz_compress_epi64(k, a));
+#   else
+      _mm512_mask_cvtepi64_storeu_epi16(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi64(k & mask_max, a));
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_cvtepi64_storeu_epi16(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi64(k, a));
+  } else if constexpr (16 == arity) {
+    _mm512_mask_cvtepi32_storeu_epi16(base_addr, (1u << n) - 1, _mm512_maskz_compress_epi32(k, a));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mget32(maskT const &k, void const *mem_addr) -> baseT {
+  // expanding into the low dword of each active quadword zero-extends it.
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_maskz_expandloadu_epi32(spread(k), mem_addr);
+#   else
+      return _mm512_maskz_expandloadu_epi32(spread(k & mask_max), mem_addr);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_maskz_expandloadu_epi32(spread(k), mem_addr);
+  } else if constexpr (16 == arity) {
+    return _mm512_maskz_expandloadu_epi32(k, mem_addr);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mput32(void *base_addr, maskT const &k, baseT const &a) -> void {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_compressstoreu_epi32(base_addr, spread(k), a);
+#   else
+      _mm512_mask_compressstoreu_epi32(base_addr, spread(k & mask_max), a);
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_compressstoreu_epi32(base_addr, spread(k), a);
+  } else if constexpr (16 == arity) {
+    _mm512_mask_compressstoreu_epi32(base_addr, k, a);
+  }
 }
 
 template <int arity>
 inline auto abi<simd::avx<arity>>::gather(baseT const &vindex, void const *base_addr) -> baseT {
-  auto const zero = set(0);
   if constexpr (4 == arity) {
 #   if pp_qword && pp_vlext
-      return _mm256_i64gather_epi64(base_addr, vindex, 8);
+      return _mm256_i64gather_epi64(static_cast<long long const*>(base_addr), vindex, 8);
 #   else
-      return _mm512_mask_i64gather_epi64(zero, mask_max, vindex, base_addr, 8);
+      return _mm512_mask_i64gather_epi64(set(0), mask_max, vindex, base_addr, 8);
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_i64gather_epi64(vindex, base_addr, 8);
+  } else if constexpr (16 == arity) {
+    return _mm512_i32gather_epi32(vindex, base_addr, 4);
   }
 }
 
@@ -329,6 +647,38 @@ inline auto abi<simd::avx<arity>>::scatter(void *base_addr, baseT const &vindex,
 #   endif
   } else if constexpr (8 == arity) {
     _mm512_i64scatter_epi64(base_addr, vindex, a, 8);
+  } else if constexpr (16 == arity) {
+    _mm512_i32scatter_epi32(base_addr, vindex, a, 4);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mgather(maskT const &k, baseT const &vindex, void const *base_addr) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mmask_i64gather_epi64(set(0), k, vindex, base_addr, 8);
+#   else
+      return _mm512_mask_i64gather_epi64(set(0), k & mask_max, vindex, base_addr, 8);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_i64gather_epi64(set(0), k, vindex, base_addr, 8);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_i32gather_epi32(set(0), k, vindex, base_addr, 4);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mscatter(void *base_addr, maskT const &k, baseT const &vindex, baseT const &a) -> void {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      _mm256_mask_i64scatter_epi64(base_addr, k, vindex, a, 8);
+#   else
+      _mm512_mask_i64scatter_epi64(base_addr, k & mask_max, vindex, a, 8);
+#   endif
+  } else if constexpr (8 == arity) {
+    _mm512_mask_i64scatter_epi64(base_addr, k, vindex, a, 8);
+  } else if constexpr (16 == arity) {
+    _mm512_mask_i32scatter_epi32(base_addr, k, vindex, a, 4);
   }
 }
 
@@ -347,6 +697,8 @@ inline auto abi<simd::avx<arity>>::add(baseT const &a, baseT const &b) -> baseT
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_add_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_add_epi32(a, b);
   }
 }
 
@@ -360,6 +712,8 @@ inline auto abi<simd::avx<arity>>::sub(baseT const &a, baseT const &b) -> baseT
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_sub_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_sub_epi32(a, b);
   }
 }
 
@@ -373,6 +727,8 @@ inline auto abi<simd::avx<arity>>::mul(baseT const &a, baseT const &b) -> baseT
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_mullox_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mullo_epi32(a, b);
   }
 }
 
@@ -393,6 +749,9 @@ inline auto abi<simd::avx<arity>>::div(baseT const &a, baseT const &b) -> baseT
   } else if constexpr (8 == arity) {
     _mm512_store_epi64(reinterpret_cast<__m512i*>(p), a);
     _mm512_store_epi64(reinterpret_cast<__m512i*>(q), b);
+  } else if constexpr (16 == arity) {
+    _mm512_store_epi32(reinterpret_cast<__m512i*>(p), a);
+    _mm512_store_epi32(reinterpret_cast<__m512i*>(q), b);
   }
 
   for (auto i = 0; i < arity; i++)
@@ -404,8 +763,210 @@ inline auto abi<simd::avx<arity>>::div(baseT const &a, baseT const &b) -> baseT
 #   else
       return _mm512_maskz_load_epi64(mask_max, r);
 #   endif
-  } else {
+  } else if constexpr (8 == arity) {
     return _mm512_load_epi64(r);
+  } else if constexpr (16 == arity) {
+    return _mm512_load_epi32(r);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::madd(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mask_add_epi64(a, k, a, b);
+#   else
+      return _mm512_mask_add_epi64(a, k, a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_add_epi64(a, k, a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_add_epi32(a, k, a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::msub(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mask_sub_epi64(a, k, a, b);
+#   else
+      return _mm512_mask_sub_epi64(a, k, a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_sub_epi64(a, k, a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_sub_epi32(a, k, a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mmul(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mask_mullo_epi64(a, k, a, b);
+#   else
+      return _mm512_mask_mullox_epi64(a, k, a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_mullox_epi64(a, k, a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_mullo_epi32(a, k, a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mdiv(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  // inactive lanes divide by one, so their divisor need not be valid.
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return div(a, _mm256_mask_mov_epi64(set(1), k, b));
+#   else
+      return div(a, _mm512_mask_mov_epi64(set(1), k, b));
+#   endif
+  } else if constexpr (8 == arity) {
+    return div(a, _mm512_mask_mov_epi64(set(1), k, b));
+  } else if constexpr (16 == arity) {
+    return div(a, _mm512_mask_mov_epi32(set(1), k, b));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mulu32(baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mul_epu32(a, b);
+#   else
+      return _mm512_mul_epu32(a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mul_epu32(a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mulhi(baseT const &a, baseT const &b) -> baseT {
+  if constexpr (16 == arity) {
+    // high halves of the even lanes' products land in the low dwords, those
+    // of the odd lanes' products in the high dwords.
+    auto const even = _mm512_srli_epi64(_mm512_mul_epu32(a, b), 32);
+    auto const odd  = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+    return _mm512_mask_blend_epi32(0xaaaa, even, odd);
+  } else {
+    // high half of the 128-bit product, from four 32 x 32 -> 64 bit products.
+    auto const lo = set(0xffffffff);
+    auto const ah = bsr(a, 32);
+    auto const bh = bsr(b, 32);
+
+    auto const ll = mulu32(a, b);
+    auto const lh = mulu32(a, bh);
+    auto const hl = mulu32(ah, b);
+    auto const hh = mulu32(ah, bh);
+
+    auto const mid = add(add(bsr(ll, 32), land(lh, lo)), land(hl, lo));
+    return add(add(hh, bsr(lh, 32)), add(bsr(hl, 32), bsr(mid, 32)));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::divr(baseT const &a, baseT const &m, baseT const &s1, baseT const &s2) -> baseT {
+  auto const t = mulhi(m, a);
+  return bsrv(add(t, bsrv(sub(a, t), s1)), s2);
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::muladd(baseT const &a, baseT const &b, baseT const &c) -> baseT {
+  return add(mul(a, b), c);
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::muladd52(baseT const &a, baseT const &b, baseT const &c) -> baseT {
+  if constexpr (16 == arity) {
+    return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c);
+  } else {
+#   if pp_ifma
+      if constexpr (4 == arity) {
+#       if pp_qword && pp_vlext
+          return _mm256_madd52lo_epu64(c, a, b);
+#       else
+          return _mm512_madd52lo_epu64(c, a, b);
+#       endif
+      } else {
+        return _mm512_madd52lo_epu64(c, a, b);
+      }
+#   else
+      // both factors fit in 32 bits, so one widening multiply is the full
+      // product.
+      return add(mulu32(a, b), c);
+#   endif
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::divmod52(baseT const &a, baseT const &b, baseT &r) -> baseT {
+  // every 64-bit lane is below 2^52, so is exact as a double, whose bits are
+  // those of 2^52 + x less those of 2^52. The truncated quotient of two is
+  // exact too: rounding up to n = ceil(a / b) would take n - a / b >= 1 / b
+  // to be within half an ulp of n, i.e. b * n > 2^53, yet b * n < a + b. So
+  // is the remainder, as q * b <= a.
+  constexpr std::int64_t two52 = 0x4330000000000000;
+
+  if constexpr (4 == arity && pp_qword && pp_vlext) {
+    auto const e  = _mm256_set1_epi64x(two52);
+    auto const ed = _mm256_castsi256_pd(e);
+    auto const ad = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_epi64(a, e)), ed);
+    auto const bd = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_epi64(b, e)), ed);
+    auto const qd = _mm256_round_pd(_mm256_div_pd(ad, bd), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto const rd = _mm256_sub_pd(ad, _mm256_mul_pd(qd, bd));
+
+    r = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(rd, ed)), e);
+    return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(qd, ed)), e);
+  } else {
+    auto const e  = _mm512_set1_epi64(two52);
+    auto const ed = _mm512_castsi512_pd(e);
+    auto const ad = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_epi64(a, e)), ed);
+    auto const bd = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_epi64(b, e)), ed);
+    auto const qd = _mm512_roundscale_pd(_mm512_div_pd(ad, bd), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    auto const rd = _mm512_sub_pd(ad, _mm512_mul_pd(qd, bd));
+
+    r = _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(rd, ed)), e);
+    return _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(qd, ed)), e);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::divmod(baseT const &a, baseT const &b, baseT &r) -> baseT {
+  if constexpr (16 == arity) {
+    // the even and the odd lanes, each widened to 64 bits.
+    auto const lo = _mm512_set1_epi64(0xffffffff);
+
+    baseT even, odd;
+    auto const qe = divmod52(_mm512_and_epi64(a, lo), _mm512_and_epi64(b, lo), even);
+    auto const qo = divmod52(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32), odd);
+
+    r = _mm512_mask_blend_epi32(0xaaaa, even, _mm512_slli_epi64(odd, 32));
+    return _mm512_mask_blend_epi32(0xaaaa, qe, _mm512_slli_epi64(qo, 32));
+  } else {
+    if (0 == cmpgt(lor(a, b), set((static_cast<unitT>(1) << 52) - 1)))
+      return divmod52(a, b, r);
+
+    // wider lanes than a double holds are divided one at a time, each
+    // scalar division yielding both results.
+    unitT p[arity];
+    unitT q[arity];
+    unitT x[arity];
+    unitT y[arity];
+
+    cpy(p, a);
+    cpy(q, b);
+
+    for (auto i = 0; i < arity; i++) {
+      x[i] = p[i] / q[i];
+      y[i] = p[i] % q[i];
+    }
+
+    r = lod(y);
+    return lod(x);
   }
 }
 
@@ -419,6 +980,8 @@ inline auto abi<simd::avx<arity>>::bsr(baseT const &a, unsigned int const &imm8)
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_srli_epi64(a, imm8);
+  } else if constexpr (16 == arity) {
+    return _mm512_srli_epi32(a, imm8);
   }
 }
 
@@ -432,9 +995,31 @@ inline auto abi<simd::avx<arity>>::bsl(baseT const &a, unsigned int const &imm8)
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_slli_epi64(a, imm8);
+  } else if constexpr (16 == arity) {
+    return _mm512_slli_epi32(a, imm8);
   }
 }
 
+template <int arity>
+inline auto abi<simd::avx<arity>>::bsrv(baseT const &a, baseT const &count) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_srlv_epi64(a, count);
+#   else
+      return _mm512_srlv_epi64(a, count);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_srlv_epi64(a, count);
+  } else if constexpr (16 == arity) {
+    return _mm512_srlv_epi32(a, count);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::bsrm(baseT const &a, unsigned int const &imm8, baseT const &m) -> baseT {
+  return land(bsr(a, imm8), m);
+}
+
 template <int arity>
 inline auto abi<simd::avx<arity>>::mbsl(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT {
   if constexpr (4 == arity) {
@@ -445,6 +1030,38 @@ inline auto abi<simd::avx<arity>>::mbsl(maskT const &k, baseT const &a, unsigned
 #    endif
   } else if constexpr (8 == arity) {
     return _mm512_mask_slli_epi64(a, k, a, imm8);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_slli_epi32(a, k, a, imm8);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mbsr(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT {
+  if constexpr (4 == arity) {
+#    if pp_qword && pp_vlext
+       return _mm256_mask_srli_epi64(a, k, a, imm8);
+#    else
+       return _mm512_mask_srli_epi64(a, k, a, imm8);
+#    endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_srli_epi64(a, k, a, imm8);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_srli_epi32(a, k, a, imm8);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::land(baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_and_si256(a, b);
+#   else
+      return _mm512_and_epi64(a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_and_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_and_epi32(a, b);
   }
 }
 
@@ -458,6 +1075,8 @@ inline auto abi<simd::avx<arity>>::lor(baseT const &a, baseT const &b) -> baseT
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_or_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_or_epi32(a, b);
   }
 }
 
@@ -471,12 +1090,190 @@ inline auto abi<simd::avx<arity>>::eor(baseT const &a, baseT const &b) -> baseT
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_xor_epi64(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_xor_epi32(a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::mlor(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mask_or_epi64(a, k, a, b);
+#   else
+      return _mm512_mask_or_epi64(a, k, a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_or_epi64(a, k, a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_or_epi32(a, k, a, b);
   }
 }
 
+template <int arity>
+inline auto abi<simd::avx<arity>>::meor(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_mask_xor_epi64(a, k, a, b);
+#   else
+      return _mm512_mask_xor_epi64(a, k, a, b);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_mask_xor_epi64(a, k, a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_mask_xor_epi32(a, k, a, b);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::hadd(baseT const &a) -> unitT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm512_mask_reduce_add_epi64(mask_max, _mm512_zextsi256_si512(a));
+#   else
+      return _mm512_mask_reduce_add_epi64(mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_reduce_add_epi64(a);
+  } else if constexpr (16 == arity) {
+    return _mm512_reduce_add_epi32(a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::hmin(baseT const &a) -> unitT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm512_mask_reduce_min_epu64(mask_max, _mm512_zextsi256_si512(a));
+#   else
+      return _mm512_mask_reduce_min_epu64(mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_reduce_min_epu64(a);
+  } else if constexpr (16 == arity) {
+    return _mm512_reduce_min_epu32(a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::hmax(baseT const &a) -> unitT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm512_mask_reduce_max_epu64(mask_max, _mm512_zextsi256_si512(a));
+#   else
+      return _mm512_mask_reduce_max_epu64(mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_reduce_max_epu64(a);
+  } else if constexpr (16 == arity) {
+    return _mm512_reduce_max_epu32(a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::hlor(baseT const &a) -> unitT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm512_mask_reduce_or_epi64(mask_max, _mm512_zextsi256_si512(a));
+#   else
+      return _mm512_mask_reduce_or_epi64(mask_max, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_reduce_or_epi64(a);
+  } else if constexpr (16 == arity) {
+    return _mm512_reduce_or_epi32(a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::heor(baseT const &a) -> unitT {
+  // there is no xor reduction, so fold the upper lanes onto the lower ones by
+  // rotating the register; only the lowest lane is meaningful.
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      auto x = eor(a, _mm256_alignr_epi64(a, a, 2));
+      x = eor(x, _mm256_alignr_epi64(x, x, 1));
+      return _mm_cvtsi128_si64(_mm256_castsi256_si128(x));
+#   else
+      auto x = eor(a, _mm512_alignr_epi64(a, a, 2));
+      x = eor(x, _mm512_alignr_epi64(x, x, 1));
+      return _mm_cvtsi128_si64(_mm512_castsi512_si128(x));
+#   endif
+  } else if constexpr (8 == arity) {
+    auto x = eor(a, _mm512_alignr_epi64(a, a, 4));
+    x = eor(x, _mm512_alignr_epi64(x, x, 2));
+    x = eor(x, _mm512_alignr_epi64(x, x, 1));
+    return _mm_cvtsi128_si64(_mm512_castsi512_si128(x));
+  } else if constexpr (16 == arity) {
+    auto x = eor(a, _mm512_alignr_epi32(a, a, 8));
+    x = eor(x, _mm512_alignr_epi32(x, x, 4));
+    x = eor(x, _mm512_alignr_epi32(x, x, 2));
+    x = eor(x, _mm512_alignr_epi32(x, x, 1));
+    return _mm512_cvtsi512_si32(x);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::iscan(baseT const &a) -> baseT {
+  // log2(arity) steps, each adding the register shifted up by twice as many
+  // lanes as the last, with zeros shifted in.
+  auto const z = set(0);
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      auto x = add(a, _mm256_alignr_epi64(a, z, 3));
+      return add(x, _mm256_alignr_epi64(x, z, 2));
+#   else
+      auto x = add(a, _mm512_alignr_epi64(a, z, 7));
+      return add(x, _mm512_alignr_epi64(x, z, 6));
+#   endif
+  } else if constexpr (8 == arity) {
+    auto x = add(a, _mm512_alignr_epi64(a, z, 7));
+    x = add(x, _mm512_alignr_epi64(x, z, 6));
+    return add(x, _mm512_alignr_epi64(x, z, 4));
+  } else if constexpr (16 == arity) {
+    auto x = add(a, _mm512_alignr_epi32(a, z, 15));
+    x = add(x, _mm512_alignr_epi32(x, z, 14));
+    x = add(x, _mm512_alignr_epi32(x, z, 12));
+    return add(x, _mm512_alignr_epi32(x, z, 8));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::escan(baseT const &a) -> baseT {
+  return sub(iscan(a), a);
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::perm(baseT const &a, baseT const &idx) -> baseT {
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      return _mm256_permutexvar_epi64(idx, a);
+#   else
+      return _mm512_permutexvar_epi64(idx, a);
+#   endif
+  } else if constexpr (8 == arity) {
+    return _mm512_permutexvar_epi64(idx, a);
+  } else if constexpr (16 == arity) {
+    return _mm512_permutexvar_epi32(idx, a);
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx<arity>>::bcst(baseT const &a, unsigned int const &lane) -> baseT {
+  return perm(a, set(lane));
+}
+
 template <int arity>
 inline auto abi<simd::avx<arity>>::mcnt(maskT const &k) -> int {
-  return __builtin_popcount(_cvtmask8_u32(k));
+  if constexpr (16 == arity) {
+    return __builtin_popcount(_cvtmask16_u32(k));
+  } else {
+#   if pp_qword
+      return __builtin_popcount(_cvtmask8_u32(k));
+#   else
+      return __builtin_popcount(k);
+#   endif
+  }
 }
 
 template <int arity>
@@ -489,6 +1286,8 @@ inline auto abi<simd::avx<arity>>::cmpgt(baseT const& a, baseT const& b) -> mask
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_cmpgt_epu64_mask(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_cmpgt_epu32_mask(a, b);
   }
 }
 
@@ -502,6 +1301,8 @@ inline auto abi<simd::avx<arity>>::cmple(baseT const& a, baseT const& b) -> mask
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_cmple_epu64_mask(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_cmple_epu32_mask(a, b);
   }
 }
 
@@ -515,6 +1316,8 @@ inline auto abi<simd::avx<arity>>::cmpeq(baseT const& a, baseT const& b) -> mask
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_cmpeq_epu64_mask(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_cmpeq_epu32_mask(a, b);
   }
 }
 
@@ -528,9 +1331,51 @@ inline auto abi<simd::avx<arity>>::cmpne(baseT const& a, baseT const& b) -> mask
 #   endif
   } else if constexpr (8 == arity) {
     return _mm512_cmpneq_epu64_mask(a, b);
+  } else if constexpr (16 == arity) {
+    return _mm512_cmpneq_epu32_mask(a, b);
+  }
+}
+
+#if pp_cnfl
+template <int arity>
+inline auto abi<simd::avx<arity>>::cnfl(baseT const &a) -> baseT {
+  // count, per lane, the lower lanes that hold the same value.
+  baseT c;
+  if constexpr (4 == arity) {
+#   if pp_qword && pp_vlext
+      c = _mm256_conflict_epi64(a);
+#   else
+      c = _mm512_conflict_epi64(a);
+#   endif
+  } else if constexpr (8 == arity) {
+    c = _mm512_conflict_epi64(a);
+  } else if constexpr (16 == arity) {
+    c = _mm512_conflict_epi32(a);
   }
+
+# if pp_vpcnt
+    if constexpr (4 == arity) {
+#     if pp_qword && pp_vlext
+        return _mm256_popcnt_epi64(c);
+#     else
+        return _mm512_popcnt_epi64(c);
+#     endif
+    } else if constexpr (8 == arity) {
+      return _mm512_popcnt_epi64(c);
+    } else if constexpr (16 == arity) {
+      return _mm512_popcnt_epi32(c);
+    }
+# else
+    // at most 15 bits are set, so a narrow swar popcount is enough.
+    c = sub(c, land(bsr(c, 1), set(0x5555)));
+    c = add(land(c, set(0x3333)), land(bsr(c, 2), set(0x3333)));
+    c = land(add(c, bsr(c, 4)), set(0x0f0f));
+    return land(add(c, bsr(c, 8)), set(0x1f));
+# endif
 }
+#endif
 
+} // inline namespace COMP_CORE_ISA_NAMESPACE
 } // namespace internal
 } // namespace core
 } // namespace comp
@@ -538,5 +1383,8 @@ inline auto abi<simd::avx<arity>>::cmpne(baseT const& a, baseT const& b) -> mask
 #undef pp_qword
 #undef pp_vlext
 #undef pp_vbmi2
+#undef pp_cnfl
+#undef pp_vpcnt
+#undef pp_ifma
 
 #endif // COMP_CORE_INTERNAL_SIMD_AVX_H
@@ -0,0 +1,707 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_INTERNAL_SIMD_AVX2_H
+#define COMP_CORE_INTERNAL_SIMD_AVX2_H 1
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <immintrin.h>
+
+#include "core/internal/abi.h"
+
+#define HAS_SIMD_INSTRUCTIONS
+
+//------------------------------------------------------------------------------
+// internal::simd::avx2<> type.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+namespace simd {
+
+template <int arity>
+class avx2;
+
+template <>
+class avx2<4> {
+  public:
+    using baseT = __m256i;
+    // AVX2 has no mask registers, so masks are kept as a bit per lane in a
+    // general purpose register and widened to a vector mask when needed.
+    using maskT = std::uint8_t;
+    using unitT = std::uint64_t;
+
+    static constexpr maskT mask_max = 0xf;
+};
+
+} // namespace simd
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// abi specialization for internal::simd::avx2<> type.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+template <int ARITY>
+class abi<simd::avx2<ARITY>> {
+  private:
+    using unitT = typename simd::avx2<ARITY>::unitT;
+    using baseT = typename simd::avx2<ARITY>::baseT;
+    using maskT = typename simd::avx2<ARITY>::maskT;
+
+    // pshufb controls which move byte i of a packed word to the i-th set lane
+    // of a mask (expand) and vice versa (compress); 0x80 zeroes the byte.
+    static constexpr auto make_ctl(bool const expand) -> std::array<std::uint32_t, 16> {
+      std::array<std::uint32_t, 16> ctl = { 0 };
+      for (int k = 0; k < 16; k++) {
+        std::uint32_t c = 0x80808080u;
+        for (int j = 0, n = 0; j < 4; j++) {
+          if (k & (1 << j)) {
+            auto const pos = expand ? j : n;
+            auto const src = expand ? n : j;
+            c = (c & ~(0xffu << (8 * pos))) | (static_cast<std::uint32_t>(src) << (8 * pos));
+            n++;
+          }
+        }
+        ctl[k] = c;
+      }
+      return ctl;
+    }
+
+    static constexpr std::array<std::uint32_t, 16> expand_ctl   = make_ctl(true);
+    static constexpr std::array<std::uint32_t, 16> compress_ctl = make_ctl(false);
+
+    static auto vmask(maskT const &k) -> baseT;
+    static auto narrow(baseT const &a) -> std::uint32_t;
+    static auto narrow16(baseT const &a) -> std::uint64_t;
+    static auto first(int const &n) -> __m128i;
+    static auto vcmpgt(baseT const &a, baseT const &b) -> baseT;
+    static auto divmod52(baseT const &a, baseT const &b, baseT &r) -> baseT;
+
+    template <class funcT>
+    static auto fold(baseT const &a, funcT const &f) -> unitT;
+
+  public:
+    using unit_type = unitT;
+    using base_type = baseT;
+    using mask_type = maskT;
+
+    static constexpr auto arity = ARITY;
+
+    static constexpr auto unit_max = std::numeric_limits<unitT>::max();
+    static constexpr auto mask_max = simd::avx2<ARITY>::mask_max;
+
+    static constexpr auto unit_width = static_cast<int>(sizeof(unitT) * CHAR_BIT);
+    //! bytes from its address that mget() may read, all of which must be
+    //! readable
+    static constexpr auto mget_span = ARITY;
+
+    static auto set(const unitT &a) -> baseT;
+    static auto get(void const *a) -> baseT;
+    static auto put(void *base_addr, baseT const& a) -> void;
+    static auto cpy(void *base_addr, baseT const& a) -> void;
+    static auto lod(void const *mem_addr) -> baseT;
+
+    static auto mget(maskT const &k, void const *mem_addr) -> baseT;
+    static auto mput(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mcpy(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mlod(maskT const &k, void const *mem_addr) -> baseT;
+
+    static auto get16(void const *mem_addr) -> baseT;
+    static auto put16(void *base_addr, baseT const &a) -> void;
+    static auto get32(void const *mem_addr) -> baseT;
+    static auto put32(void *base_addr, baseT const &a) -> void;
+
+    static auto mget16(maskT const &k, void const *mem_addr) -> baseT;
+    static auto mput16(void *base_addr, maskT const &k, baseT const &a) -> void;
+    static auto mget32(maskT const &k, void const *mem_addr) -> baseT;
+    static auto mput32(void *base_addr, maskT const &k, baseT const &a) -> void;
+
+    static auto gather(baseT const &vindex, void const *base_addr) -> baseT;
+    static auto scatter(void *base_addr, baseT const &vindex, baseT const &a) -> void;
+    static auto mgather(maskT const &k, baseT const &vindex, void const *base_addr) -> baseT;
+    static auto mscatter(void *base_addr, maskT const &k, baseT const &vindex, baseT const &a) -> void;
+
+    static auto neg(baseT const &a) -> baseT;
+
+    static auto add(baseT const &a, baseT const &b) -> baseT;
+    static auto sub(baseT const &a, baseT const &b) -> baseT;
+    static auto mul(baseT const &a, baseT const &b) -> baseT;
+    static auto div(baseT const &a, baseT const &b) -> baseT;
+
+    static auto madd(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto msub(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto mmul(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto mdiv(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+
+    static auto mulhi(baseT const &a, baseT const &b) -> baseT;
+    static auto divr(baseT const &a, baseT const &m, baseT const &s1, baseT const &s2) -> baseT;
+
+    static auto muladd(baseT const &a, baseT const &b, baseT const &c) -> baseT;
+    static auto muladd52(baseT const &a, baseT const &b, baseT const &c) -> baseT;
+    static auto divmod(baseT const &a, baseT const &b, baseT &r) -> baseT;
+
+    static auto bsr(baseT const &a, unsigned int const &imm8) -> baseT;
+    static auto bsl(baseT const &a, unsigned int const &imm8) -> baseT;
+
+    static auto bsrv(baseT const &a, baseT const &count) -> baseT;
+    static auto bsrm(baseT const &a, unsigned int const &imm8, baseT const &m) -> baseT;
+
+    static auto mbsl(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT;
+    static auto mbsr(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT;
+
+    static auto land(baseT const &a, baseT const &b) -> baseT;
+    static auto lor(baseT const &a, baseT const &b) -> baseT;
+    static auto eor(baseT const &a, baseT const &b) -> baseT;
+
+    static auto mlor(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+    static auto meor(maskT const &k, baseT const &a, baseT const &b) -> baseT;
+
+    static auto hadd(baseT const &a) -> unitT;
+    static auto hmin(baseT const &a) -> unitT;
+    static auto hmax(baseT const &a) -> unitT;
+    static auto hlor(baseT const &a) -> unitT;
+    static auto heor(baseT const &a) -> unitT;
+
+    static auto iscan(baseT const &a) -> baseT;
+    static auto escan(baseT const &a) -> baseT;
+
+    static auto perm(baseT const &a, baseT const &idx) -> baseT;
+    static auto bcst(baseT const &a, unsigned int const &lane) -> baseT;
+
+    static auto mcnt(maskT const &k) -> int;
+
+    static auto cmpgt(baseT const &a, baseT const &b) -> maskT;
+    static auto cmple(baseT const &a, baseT const &b) -> maskT;
+    static auto cmpeq(baseT const &a, baseT const &b) -> maskT;
+    static auto cmpne(baseT const &a, baseT const &b) -> maskT;
+};
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+//------------------------------------------------------------------------------
+// abi implementation for internal::simd::avx2<> type.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::vmask(maskT const &k) -> baseT {
+  auto const bits = _mm256_set_epi64x(8, 4, 2, 1);
+  return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(k), bits), bits);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::narrow(baseT const &a) -> std::uint32_t {
+  // low dword of each lane to the low 128 bits, then low byte of each dword.
+  auto const b = _mm256_permutevar8x32_epi32(a, _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0));
+  auto const c = _mm_shuffle_epi8(_mm256_castsi256_si128(b), _mm_cvtsi32_si128(0x0c080400));
+  return static_cast<std::uint32_t>(_mm_cvtsi128_si32(c));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::narrow16(baseT const &a) -> std::uint64_t {
+  // as narrow, but keeping the low word of each dword.
+  auto const b = _mm256_permutevar8x32_epi32(a, _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0));
+  auto const c = _mm_shuffle_epi8(_mm256_castsi256_si128(b), _mm_cvtsi64_si128(0x0d0c090805040100));
+  return static_cast<std::uint64_t>(_mm_cvtsi128_si64(c));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::first(int const &n) -> __m128i {
+  // dword mask of the first n of four.
+  return _mm_cmpgt_epi32(_mm_set1_epi32(n), _mm_set_epi32(3, 2, 1, 0));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::vcmpgt(baseT const &a, baseT const &b) -> baseT {
+  // AVX2 only compares signed quadwords, so bias both sides by 2^63.
+  auto const bias = _mm256_set1_epi64x(std::numeric_limits<long long>::min());
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+}
+
+template <int arity>
+template <class funcT>
+inline auto abi<simd::avx2<arity>>::fold(baseT const &a, funcT const &f) -> unitT {
+  // combine the halves, then the pairs; the lowest lane holds the result.
+  auto const x = f(a, _mm256_permute4x64_epi64(a, 0x4e));
+  auto const y = f(x, _mm256_permute4x64_epi64(x, 0xb1));
+  return static_cast<unitT>(_mm_cvtsi128_si64(_mm256_castsi256_si128(y)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::set(unitT const& a) -> baseT {
+  return _mm256_set1_epi64x(a);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::get(void const *mem_addr) -> baseT {
+  std::uint32_t w;
+  std::memcpy(&w, mem_addr, sizeof(w));
+  return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(w));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::put(void *base_addr, baseT const& a) -> void {
+  auto const w = narrow(a);
+  std::memcpy(base_addr, &w, sizeof(w));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::cpy(void *base_addr, baseT const& a) -> void {
+  _mm256_storeu_si256(static_cast<__m256i*>(base_addr), a);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::lod(void const *mem_addr) -> baseT {
+  return _mm256_loadu_si256(static_cast<__m256i const*>(mem_addr));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mcpy(void *base_addr, maskT const &k, baseT const &a) -> void {
+  _mm256_maskstore_epi64(static_cast<long long*>(base_addr), vmask(k), a);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mlod(maskT const &k, void const *mem_addr) -> baseT {
+  return _mm256_maskload_epi64(static_cast<long long const*>(mem_addr), vmask(k));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mget(maskT const &k, void const *mem_addr) -> baseT {
+  auto const *m = static_cast<unsigned char const*>(mem_addr);
+  auto const  n = mcnt(k);
+
+  // never touch more than the mcnt(k) bytes that belong to the caller.
+  std::uint32_t w = 0;
+  for (int j = 0; j < n; j++)
+    w |= static_cast<std::uint32_t>(m[j]) << (8 * j);
+
+  auto const b = _mm_shuffle_epi8(_mm_cvtsi32_si128(w), _mm_cvtsi32_si128(expand_ctl[k]));
+  return _mm256_cvtepu8_epi64(b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mput(void *base_addr, maskT const &k, baseT const &a) -> void {
+  auto *m = static_cast<unsigned char*>(base_addr);
+  auto const n = mcnt(k);
+
+  auto const b = _mm_shuffle_epi8(_mm_cvtsi32_si128(narrow(a)), _mm_cvtsi32_si128(compress_ctl[k]));
+  auto const w = static_cast<std::uint32_t>(_mm_cvtsi128_si32(b));
+
+  if (4 == n) {
+    std::memcpy(m, &w, sizeof(w));
+  } else {
+    if (n & 2) {
+      std::uint16_t const h = w;
+      std::memcpy(m, &h, sizeof(h));
+    }
+    if (n & 1)
+      m[n - 1] = static_cast<unsigned char>(w >> (8 * (n - 1)));
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::get16(void const *mem_addr) -> baseT {
+  return _mm256_cvtepu16_epi64(_mm_loadl_epi64(static_cast<__m128i const*>(mem_addr)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::put16(void *base_addr, baseT const &a) -> void {
+  auto const w = narrow16(a);
+  std::memcpy(base_addr, &w, sizeof(w));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::get32(void const *mem_addr) -> baseT {
+  return _mm256_cvtepu32_epi64(_mm_loadu_si128(static_cast<__m128i const*>(mem_addr)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::put32(void *base_addr, baseT const &a) -> void {
+  auto const b = _mm256_permutevar8x32_epi32(a, _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0));
+  _mm_storeu_si128(static_cast<__m128i*>(base_addr), _mm256_castsi256_si128(b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mget16(maskT const &k, void const *mem_addr) -> baseT {
+  auto const *m = static_cast<unsigned char const*>(mem_addr);
+  auto const  n = mcnt(k);
+
+  // never touch more than the 2 * mcnt(k) bytes that belong to the caller.
+  std::uint64_t w = 0;
+  for (int j = 0; j < n; j++) {
+    std::uint16_t h;
+    std::memcpy(&h, m + 2 * j, sizeof(h));
+    w |= static_cast<std::uint64_t>(h) << (16 * j);
+  }
+
+  auto const b = _mm256_cvtepu16_epi64(_mm_cvtsi64_si128(static_cast<long long>(w)));
+  auto const i = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(expand_ctl[k]));
+  return _mm256_and_si256(perm(b, i), vmask(k));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mput16(void *base_addr, maskT const &k, baseT const &a) -> void {
+  auto *m = static_cast<unsigned char*>(base_addr);
+  auto const n = mcnt(k);
+
+  auto const i = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(compress_ctl[k]));
+  auto const w = narrow16(perm(a, i));
+
+  if (4 == n) {
+    std::memcpy(m, &w, sizeof(w));
+  } else {
+    if (n & 2) {
+      std::uint32_t const h = static_cast<std::uint32_t>(w);
+      std::memcpy(m, &h, sizeof(h));
+    }
+    if (n & 1) {
+      std::uint16_t const h = static_cast<std::uint16_t>(w >> (16 * (n - 1)));
+      std::memcpy(m + 2 * (n - 1), &h, sizeof(h));
+    }
+  }
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mget32(maskT const &k, void const *mem_addr) -> baseT {
+  // the masked load does not fault on the dwords it skips.
+  auto const b = _mm_maskload_epi32(static_cast<int const*>(mem_addr), first(mcnt(k)));
+  auto const i = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(expand_ctl[k]));
+  return _mm256_and_si256(perm(_mm256_cvtepu32_epi64(b), i), vmask(k));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mput32(void *base_addr, maskT const &k, baseT const &a) -> void {
+  auto const i = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(compress_ctl[k]));
+  auto const b = _mm256_permutevar8x32_epi32(perm(a, i), _mm256_set_epi32(7, 5, 3, 1, 6, 4, 2, 0));
+  _mm_maskstore_epi32(static_cast<int*>(base_addr), first(mcnt(k)), _mm256_castsi256_si128(b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::gather(baseT const &vindex, void const *base_addr) -> baseT {
+  return _mm256_i64gather_epi64(static_cast<long long const*>(base_addr), vindex, 8);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::scatter(void *base_addr, baseT const &vindex, baseT const &a) -> void {
+  // AVX2 has no scatter; lanes are stored in order so the last one wins.
+  auto *mem = static_cast<unitT*>(base_addr);
+  mem[_mm256_extract_epi64(vindex, 0)] = _mm256_extract_epi64(a, 0);
+  mem[_mm256_extract_epi64(vindex, 1)] = _mm256_extract_epi64(a, 1);
+  mem[_mm256_extract_epi64(vindex, 2)] = _mm256_extract_epi64(a, 2);
+  mem[_mm256_extract_epi64(vindex, 3)] = _mm256_extract_epi64(a, 3);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mgather(maskT const &k, baseT const &vindex, void const *base_addr) -> baseT {
+  return _mm256_mask_i64gather_epi64(set(0), static_cast<long long const*>(base_addr), vindex, vmask(k), 8);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mscatter(void *base_addr, maskT const &k, baseT const &vindex, baseT const &a) -> void {
+  auto *mem = static_cast<unitT*>(base_addr);
+  if (k & 0x1) mem[_mm256_extract_epi64(vindex, 0)] = _mm256_extract_epi64(a, 0);
+  if (k & 0x2) mem[_mm256_extract_epi64(vindex, 1)] = _mm256_extract_epi64(a, 1);
+  if (k & 0x4) mem[_mm256_extract_epi64(vindex, 2)] = _mm256_extract_epi64(a, 2);
+  if (k & 0x8) mem[_mm256_extract_epi64(vindex, 3)] = _mm256_extract_epi64(a, 3);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::neg(baseT const &a) -> baseT {
+  return sub(set(0), a);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::add(baseT const &a, baseT const &b) -> baseT {
+  return _mm256_add_epi64(a, b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::sub(baseT const &a, baseT const &b) -> baseT {
+  return _mm256_sub_epi64(a, b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mul(baseT const &a, baseT const &b) -> baseT {
+  // a * b mod 2^64 = lo(a) * lo(b) + ((hi(a) * lo(b) + lo(a) * hi(b)) << 32)
+  auto const ll = _mm256_mul_epu32(a, b);
+  auto const hl = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  auto const lh = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+  return _mm256_add_epi64(ll, _mm256_slli_epi64(_mm256_add_epi64(hl, lh), 32));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::div(baseT const &a, baseT const &b) -> baseT {
+  alignas(32) unitT p[arity];
+  alignas(32) unitT q[arity];
+  alignas(32) unitT r[arity];
+
+  _mm256_store_si256(reinterpret_cast<__m256i*>(p), a);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(q), b);
+
+  for (auto i = 0; i < arity; i++)
+    r[i] = p[i] / q[i];
+
+  return _mm256_load_si256(reinterpret_cast<__m256i const*>(r));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::madd(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  // inactive lanes add zero.
+  return _mm256_add_epi64(a, _mm256_and_si256(vmask(k), b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::msub(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  // inactive lanes subtract zero.
+  return _mm256_sub_epi64(a, _mm256_and_si256(vmask(k), b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mmul(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  return _mm256_blendv_epi8(a, mul(a, b), vmask(k));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mdiv(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  // inactive lanes divide by one, so their divisor need not be valid.
+  return div(a, _mm256_blendv_epi8(set(1), b, vmask(k)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mulhi(baseT const &a, baseT const &b) -> baseT {
+  // high half of the 128-bit product, from four 32 x 32 -> 64 bit products.
+  auto const lo = set(0xffffffff);
+  auto const ah = bsr(a, 32);
+  auto const bh = bsr(b, 32);
+
+  auto const ll = _mm256_mul_epu32(a, b);
+  auto const lh = _mm256_mul_epu32(a, bh);
+  auto const hl = _mm256_mul_epu32(ah, b);
+  auto const hh = _mm256_mul_epu32(ah, bh);
+
+  auto const mid = add(add(bsr(ll, 32), land(lh, lo)), land(hl, lo));
+  return add(add(hh, bsr(lh, 32)), add(bsr(hl, 32), bsr(mid, 32)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::divr(baseT const &a, baseT const &m, baseT const &s1, baseT const &s2) -> baseT {
+  auto const t = mulhi(m, a);
+  return bsrv(add(t, bsrv(sub(a, t), s1)), s2);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::muladd(baseT const &a, baseT const &b, baseT const &c) -> baseT {
+  return add(mul(a, b), c);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::muladd52(baseT const &a, baseT const &b, baseT const &c) -> baseT {
+  // both factors fit in 32 bits, so one widening multiply is the full product.
+  return _mm256_add_epi64(_mm256_mul_epu32(a, b), c);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::divmod52(baseT const &a, baseT const &b, baseT &r) -> baseT {
+  // every lane is below 2^52, so is exact as a double, and so are the
+  // truncated quotient and the remainder, see abi<simd::avx<>>::divmod52().
+  auto const e  = _mm256_set1_epi64x(0x4330000000000000);
+  auto const ed = _mm256_castsi256_pd(e);
+  auto const ad = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(a, e)), ed);
+  auto const bd = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(b, e)), ed);
+  auto const qd = _mm256_round_pd(_mm256_div_pd(ad, bd), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+  auto const rd = _mm256_sub_pd(ad, _mm256_mul_pd(qd, bd));
+
+  r = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(rd, ed)), e);
+  return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(qd, ed)), e);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::divmod(baseT const &a, baseT const &b, baseT &r) -> baseT {
+  if (0 == cmpgt(lor(a, b), set((static_cast<unitT>(1) << 52) - 1)))
+    return divmod52(a, b, r);
+
+  // wider lanes than a double holds are divided one at a time, each scalar
+  // division yielding both results.
+  unitT p[arity];
+  unitT q[arity];
+  unitT x[arity];
+  unitT y[arity];
+
+  cpy(p, a);
+  cpy(q, b);
+
+  for (auto i = 0; i < arity; i++) {
+    x[i] = p[i] / q[i];
+    y[i] = p[i] % q[i];
+  }
+
+  r = lod(y);
+  return lod(x);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::bsr(baseT const &a, unsigned int const &imm8) -> baseT {
+  return _mm256_srli_epi64(a, imm8);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::bsl(baseT const &a, unsigned int const &imm8) -> baseT {
+  return _mm256_slli_epi64(a, imm8);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::bsrv(baseT const &a, baseT const &count) -> baseT {
+  return _mm256_srlv_epi64(a, count);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::bsrm(baseT const &a, unsigned int const &imm8, baseT const &m) -> baseT {
+  return land(bsr(a, imm8), m);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mbsl(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT {
+  // inactive lanes are shifted by zero.
+  auto const count = _mm256_and_si256(vmask(k), _mm256_set1_epi64x(imm8));
+  return _mm256_sllv_epi64(a, count);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mbsr(maskT const &k, baseT const &a, unsigned int const &imm8) -> baseT {
+  // inactive lanes are shifted by zero.
+  auto const count = _mm256_and_si256(vmask(k), _mm256_set1_epi64x(imm8));
+  return _mm256_srlv_epi64(a, count);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::land(baseT const &a, baseT const &b) -> baseT {
+  return _mm256_and_si256(a, b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::lor(baseT const &a, baseT const &b) -> baseT {
+  return _mm256_or_si256(a, b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::eor(baseT const &a, baseT const &b) -> baseT {
+  return _mm256_xor_si256(a, b);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mlor(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  return _mm256_or_si256(a, _mm256_and_si256(vmask(k), b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::meor(maskT const &k, baseT const &a, baseT const &b) -> baseT {
+  return _mm256_xor_si256(a, _mm256_and_si256(vmask(k), b));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::hadd(baseT const &a) -> unitT {
+  return fold(a, add);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::hmin(baseT const &a) -> unitT {
+  return fold(a, [](baseT const &x, baseT const &y) {
+    return _mm256_blendv_epi8(x, y, vcmpgt(x, y));
+  });
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::hmax(baseT const &a) -> unitT {
+  return fold(a, [](baseT const &x, baseT const &y) {
+    return _mm256_blendv_epi8(y, x, vcmpgt(x, y));
+  });
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::hlor(baseT const &a) -> unitT {
+  return fold(a, lor);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::heor(baseT const &a) -> unitT {
+  return fold(a, eor);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::iscan(baseT const &a) -> baseT {
+  // add the register shifted up by one lane, then by two, zeroing the lanes
+  // shifted in.
+  auto const z = _mm256_setzero_si256();
+  auto const x = add(a, _mm256_blend_epi32(_mm256_permute4x64_epi64(a, 0x90), z, 0x03));
+  return add(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x40), z, 0x0f));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::escan(baseT const &a) -> baseT {
+  return sub(iscan(a), a);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::perm(baseT const &a, baseT const &idx) -> baseT {
+  // there is no quadword permute by vector, so move dwords 2 * idx and
+  // 2 * idx + 1 into each lane.
+  auto const lo = _mm256_slli_epi64(idx, 1);
+  auto const hi = _mm256_slli_epi64(_mm256_add_epi64(lo, _mm256_set1_epi64x(1)), 32);
+  return _mm256_permutevar8x32_epi32(a, _mm256_or_si256(lo, hi));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::bcst(baseT const &a, unsigned int const &lane) -> baseT {
+  return perm(a, set(lane));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::mcnt(maskT const &k) -> int {
+  return __builtin_popcount(k);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::cmpgt(baseT const& a, baseT const& b) -> maskT {
+  auto const c = vcmpgt(a, b);
+  return static_cast<maskT>(_mm256_movemask_pd(_mm256_castsi256_pd(c)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::cmple(baseT const& a, baseT const& b) -> maskT {
+  return static_cast<maskT>(~cmpgt(a, b) & mask_max);
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::cmpeq(baseT const& a, baseT const& b) -> maskT {
+  auto const c = _mm256_cmpeq_epi64(a, b);
+  return static_cast<maskT>(_mm256_movemask_pd(_mm256_castsi256_pd(c)));
+}
+
+template <int arity>
+inline auto abi<simd::avx2<arity>>::cmpne(baseT const& a, baseT const& b) -> maskT {
+  return static_cast<maskT>(~cmpeq(a, b) & mask_max);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_INTERNAL_SIMD_AVX2_H
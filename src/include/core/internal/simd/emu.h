@@ -2,7 +2,10 @@
 #ifndef COMP_CORE_INTERNAL_SIMD_EMU_H
 #define COMP_CORE_INTERNAL_SIMD_EMU_H 1
 
-#define COMP_EMU_MARCH_knl 0
+// an unknown march expands to 0, so every known one must be nonzero.
+#define COMP_EMU_MARCH_knl            1
+#define COMP_EMU_MARCH_skylake_avx512 2
+#define COMP_EMU_MARCH_icelake_server 3
 
 #define COMP_EMU_MARCH_VAL_impl_x(a) COMP_EMU_MARCH_ ## a
 #define COMP_EMU_MARCH_VAL_impl(a)   COMP_EMU_MARCH_VAL_impl_x(a)
@@ -10,6 +13,12 @@
 
 #if COMP_EMU_MARCH_VAL == COMP_EMU_MARCH_knl
 # include "core/internal/simd/emu/march/knl.h"
+#elif COMP_EMU_MARCH_VAL == COMP_EMU_MARCH_skylake_avx512
+# include "core/internal/simd/emu/march/skylake_avx512.h"
+#elif COMP_EMU_MARCH_VAL == COMP_EMU_MARCH_icelake_server
+# include "core/internal/simd/emu/march/icelake_server.h"
+#else
+# error "COMP_EMU_MARCH must be one of knl, skylake_avx512, icelake_server"
 #endif
 
 #endif // COMP_CORE_INTERNAL_SIMD_EMU_H
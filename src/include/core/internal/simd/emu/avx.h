@@ -2,10 +2,20 @@
 #ifndef COMP_CORE_INTERNAL_SIMD_EMU_AVX_H
 #define COMP_CORE_INTERNAL_SIMD_EMU_AVX_H 1
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 
 #define COMP_EMU_MARCH_AVX 1
 
+//------------------------------------------------------------------------------
+// portable emulation of the intrinsics used by abi<simd::avx<>>.
+//
+// Each intrinsic is defined under the same feature macros that make the real
+// one available, so whichever path avx.h selects for the emulated march is
+// exactly the path that compiles here. Memory operands are accessed with
+// memcpy, since none of them need to be aligned to the element size.
+//------------------------------------------------------------------------------
 typedef union {
   std::int64_t  i64[2];
   std::int32_t  i32[4];
@@ -39,16 +49,224 @@ typedef union {
   std::uint8_t  u8[64];
 } __m512i;
 
-using __int64  = std::int64_t;
-using __mmask8 = std::uint8_t;
+typedef union {
+  double        f64[4];
+  std::uint64_t u64[4];
+} __m256d;
+
+typedef union {
+  double        f64[8];
+  std::uint64_t u64[8];
+} __m512d;
+
+using __int64   = std::int64_t;
+using __mmask8  = std::uint8_t;
+using __mmask16 = std::uint16_t;
+using __mmask32 = std::uint32_t;
+using __mmask64 = std::uint64_t;
+
+#define _MM_FROUND_TO_NEAREST_INT 0x00
+#define _MM_FROUND_TO_NEG_INF     0x01
+#define _MM_FROUND_TO_POS_INF     0x02
+#define _MM_FROUND_TO_ZERO        0x03
+#define _MM_FROUND_NO_EXC         0x08
+
+//! Round a to an integer as directed by the low two bits of imm8.
+inline double comp_emu_round(double a, int imm8) {
+  switch (imm8 & 0x03) {
+    case _MM_FROUND_TO_NEG_INF: return std::floor(a);
+    case _MM_FROUND_TO_POS_INF: return std::ceil(a);
+    case _MM_FROUND_TO_ZERO:    return std::trunc(a);
+  }
+  return std::nearbyint(a);
+}
 
 #if defined(__SSE2__)
 inline __m128i _mm_loadu_si128(__m128i const *mem_addr) {
-  return *mem_addr;
+  __m128i dst;
+  std::memcpy(&dst, mem_addr, sizeof(dst));
+  return dst;
 }
 
 inline void _mm_storeu_si128(__m128i *mem_addr, __m128i a) {
-  *mem_addr = a;
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline __m128i _mm_loadl_epi64(__m128i const *mem_addr) {
+  __m128i dst = {};
+  std::memcpy(&dst.u64[0], mem_addr, sizeof(dst.u64[0]));
+  return dst;
+}
+
+inline __m128i _mm_cvtsi32_si128(int a) {
+  __m128i dst = {};
+  dst.i32[0] = a;
+  return dst;
+}
+
+inline int _mm_cvtsi128_si32(__m128i a) {
+  return a.i32[0];
+}
+
+inline __int64 _mm_cvtsi128_si64(__m128i a) {
+  return a.i64[0];
+}
+#endif
+
+#if defined(__AVX__)
+inline __m256i _mm256_set_epi64x(__int64 e3, __int64 e2, __int64 e1, __int64 e0) {
+  __m256i dst;
+  dst.i64[0] = e0;
+  dst.i64[1] = e1;
+  dst.i64[2] = e2;
+  dst.i64[3] = e3;
+  return dst;
+}
+
+inline __m256i _mm256_loadu_si256(__m256i const *mem_addr) {
+  __m256i dst;
+  std::memcpy(&dst, mem_addr, sizeof(dst));
+  return dst;
+}
+
+inline __m128i _mm256_castsi256_si128(__m256i a) {
+  __m128i dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m256i _mm256_set1_epi64x(long long a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.i64[i] = a;
+  return dst;
+}
+
+inline __m256d _mm256_castsi256_pd(__m256i a) {
+  __m256d dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m256i _mm256_castpd_si256(__m256d a) {
+  __m256i dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m256d _mm256_add_pd(__m256d a, __m256d b) {
+  __m256d dst;
+  for (auto i = 0; i < 4; i++)
+    dst.f64[i] = a.f64[i] + b.f64[i];
+  return dst;
+}
+
+inline __m256d _mm256_sub_pd(__m256d a, __m256d b) {
+  __m256d dst;
+  for (auto i = 0; i < 4; i++)
+    dst.f64[i] = a.f64[i] - b.f64[i];
+  return dst;
+}
+
+inline __m256d _mm256_mul_pd(__m256d a, __m256d b) {
+  __m256d dst;
+  for (auto i = 0; i < 4; i++)
+    dst.f64[i] = a.f64[i] * b.f64[i];
+  return dst;
+}
+
+inline __m256d _mm256_div_pd(__m256d a, __m256d b) {
+  __m256d dst;
+  for (auto i = 0; i < 4; i++)
+    dst.f64[i] = a.f64[i] / b.f64[i];
+  return dst;
+}
+
+inline __m256d _mm256_round_pd(__m256d a, int rounding) {
+  __m256d dst;
+  for (auto i = 0; i < 4; i++)
+    dst.f64[i] = comp_emu_round(a.f64[i], rounding);
+  return dst;
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i _mm256_cvtepu8_epi64(__m128i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u8[i];
+  return dst;
+}
+
+inline __m256i _mm256_cvtepu16_epi64(__m128i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u16[i];
+  return dst;
+}
+
+inline __m256i _mm256_cvtepu32_epi64(__m128i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u32[i];
+  return dst;
+}
+
+inline __m256i _mm256_i64gather_epi64(long long const *base_addr, __m256i vindex, int scale) {
+  __m256i dst;
+  auto const *mem = reinterpret_cast<char const*>(base_addr);
+  for (auto i = 0; i < 4; i++)
+    std::memcpy(&dst.i64[i], mem + vindex.i64[i] * scale, sizeof(dst.i64[i]));
+  return dst;
+}
+
+inline __m256i _mm256_add_epi64(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] + b.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_sub_epi64(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] - b.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mul_epu32(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = static_cast<std::uint64_t>(a.u32[2 * i]) * b.u32[2 * i];
+  return dst;
+}
+
+inline __m256i _mm256_srli_epi64(__m256i a, int imm8) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (imm8 > 63) ? 0 : a.u64[i] >> imm8;
+  return dst;
+}
+
+inline __m256i _mm256_slli_epi64(__m256i a, int imm8) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (imm8 > 63) ? 0 : a.u64[i] << imm8;
+  return dst;
+}
+
+inline __m256i _mm256_srlv_epi64(__m256i a, __m256i count) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (count.u64[i] > 63) ? 0 : a.u64[i] >> count.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_and_si256(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] & b.u64[i];
+  return dst;
 }
 #endif
 
@@ -66,6 +284,108 @@ inline __m512i _mm512_set_epi64(__int64 e7, __int64 e6, __int64 e5, __int64 e4,
   return retval;
 }
 
+inline __m512i _mm512_set1_epi32(int a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.i32[i] = a;
+  return dst;
+}
+
+inline __m512i _mm512_mask_set1_epi32(__m512i src, __mmask16 k, int a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.i32[i] = (k >> i) & 1 ? a : src.i32[i];
+  return dst;
+}
+
+inline __m512i _mm512_set1_epi64(long long a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.i64[i] = a;
+  return dst;
+}
+
+inline __m512d _mm512_castsi512_pd(__m512i a) {
+  __m512d dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m512i _mm512_castpd_si512(__m512d a) {
+  __m512i dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m512d _mm512_add_pd(__m512d a, __m512d b) {
+  __m512d dst;
+  for (auto i = 0; i < 8; i++)
+    dst.f64[i] = a.f64[i] + b.f64[i];
+  return dst;
+}
+
+inline __m512d _mm512_sub_pd(__m512d a, __m512d b) {
+  __m512d dst;
+  for (auto i = 0; i < 8; i++)
+    dst.f64[i] = a.f64[i] - b.f64[i];
+  return dst;
+}
+
+inline __m512d _mm512_mul_pd(__m512d a, __m512d b) {
+  __m512d dst;
+  for (auto i = 0; i < 8; i++)
+    dst.f64[i] = a.f64[i] * b.f64[i];
+  return dst;
+}
+
+inline __m512d _mm512_div_pd(__m512d a, __m512d b) {
+  __m512d dst;
+  for (auto i = 0; i < 8; i++)
+    dst.f64[i] = a.f64[i] / b.f64[i];
+  return dst;
+}
+
+inline __m512d _mm512_roundscale_pd(__m512d a, int imm8) {
+  // only the rounding mode is emulated; the scale, imm8[7:4], must be 0.
+  __m512d dst;
+  for (auto i = 0; i < 8; i++)
+    dst.f64[i] = comp_emu_round(a.f64[i], imm8);
+  return dst;
+}
+
+inline __m512i _mm512_castsi128_si512(__m128i a) {
+  // the upper 384 bits are undefined.
+  __m512i dst = {};
+  std::memcpy(&dst, &a, sizeof(a));
+  return dst;
+}
+
+inline __m128i _mm512_castsi512_si128(__m512i a) {
+  __m128i dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m256i _mm512_castsi512_si256(__m512i a) {
+  __m256i dst;
+  std::memcpy(&dst, &a, sizeof(dst));
+  return dst;
+}
+
+inline __m512i _mm512_zextsi256_si512(__m256i a) {
+  __m512i dst = {};
+  std::memcpy(&dst, &a, sizeof(a));
+  return dst;
+}
+
+inline int _mm512_cvtsi512_si32(__m512i a) {
+  return a.i32[0];
+}
+
+inline unsigned int _cvtmask16_u32(__mmask16 a) {
+  return a;
+}
+
 inline __m512i _mm512_cvtepu8_epi64(__m128i a) {
   __m512i dst;
   for (auto i = 0; i < 8; i++)
@@ -84,100 +404,1113 @@ inline __m512i _mm512_maskz_cvtepu8_epi64(__mmask8 k, __m128i a) {
   return dst;
 }
 
-inline void _mm512_mask_cvtepi64_storeu_epi8(void *base_addr, __mmask8 k, __m512i a) {
-  auto *mem = static_cast<uint8_t*>(base_addr);
+inline __m512i _mm512_cvtepu8_epi32(__m128i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u8[i];
+  return dst;
+}
+
+inline __m512i _mm512_cvtepu16_epi64(__m128i a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u16[i];
+  return dst;
+}
+
+inline __m512i _mm512_maskz_cvtepu16_epi64(__mmask8 k, __m128i a) {
+  __m512i dst;
   for (auto i = 0; i < 8; i++) {
     if (k & (1 << i))
-      mem[i] = a.i64[i]; // TODO: Truncate_Int64_To_Int8
+      dst.u64[i] = a.u16[i];
+    else
+      dst.u64[i] = 0;
   }
+  return dst;
 }
 
-inline void _mm512_storeu_epi64(void *mem_addr, __m512i a) {
-  // FIXME: mem_addr does not need to be aligned on any particular boundary.
-  auto *mem = static_cast<__int64*>(mem_addr);
+inline __m512i _mm512_cvtepu16_epi32(__m256i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u16[i];
+  return dst;
+}
+
+inline __m512i _mm512_cvtepu32_epi64(__m256i a) {
+  __m512i dst;
   for (auto i = 0; i < 8; i++)
-    mem[i] = a.i64[i];
+    dst.u64[i] = a.u32[i];
+  return dst;
 }
 
-inline void _mm512_mask_storeu_epi64(void *mem_addr, __mmask8 k, __m512i a) {
-  // FIXME: mem_addr does not need to be aligned on any particular boundary.
-  auto *mem = static_cast<__int64*>(mem_addr);
+inline __m128i _mm512_cvtepi64_epi8(__m512i a) {
+  __m128i dst = {};
+  for (auto i = 0; i < 8; i++)
+    dst.u8[i] = static_cast<std::uint8_t>(a.u64[i]);
+  return dst;
+}
+
+inline __m128i _mm512_cvtepi32_epi8(__m512i a) {
+  __m128i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u8[i] = static_cast<std::uint8_t>(a.u32[i]);
+  return dst;
+}
+
+inline void _mm512_mask_cvtepi64_storeu_epi8(void *base_addr, __mmask8 k, __m512i a) {
+  auto *mem = static_cast<std::uint8_t*>(base_addr);
   for (auto i = 0; i < 8; i++) {
     if (k & (1 << i))
-      mem[i] = a.i64[i];
+      mem[i] = static_cast<std::uint8_t>(a.u64[i]);
   }
 }
 
-inline __m512i _mm512_i64gather_epi64(__m512i vindex, void const *base_addr, int scale) {
+inline void _mm512_mask_cvtepi32_storeu_epi8(void *base_addr, __mmask16 k, __m512i a) {
+  auto *mem = static_cast<std::uint8_t*>(base_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      mem[i] = static_cast<std::uint8_t>(a.u32[i]);
+  }
+}
+
+inline void _mm512_mask_cvtepi64_storeu_epi16(void *base_addr, __mmask8 k, __m512i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i)) {
+      auto const w = static_cast<std::uint16_t>(a.u64[i]);
+      std::memcpy(mem + i * sizeof(w), &w, sizeof(w));
+    }
+  }
+}
+
+inline void _mm512_mask_cvtepi32_storeu_epi16(void *base_addr, __mmask16 k, __m512i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i)) {
+      auto const w = static_cast<std::uint16_t>(a.u32[i]);
+      std::memcpy(mem + i * sizeof(w), &w, sizeof(w));
+    }
+  }
+}
+
+inline void _mm512_mask_cvtepi64_storeu_epi32(void *base_addr, __mmask8 k, __m512i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i)) {
+      auto const w = static_cast<std::uint32_t>(a.u64[i]);
+      std::memcpy(mem + i * sizeof(w), &w, sizeof(w));
+    }
+  }
+}
+
+inline __m512i _mm512_loadu_si512(void const *mem_addr) {
   __m512i dst;
-  auto const *mem = static_cast<char const*>(base_addr);
-  for (auto i = 0; i < 8; i++)
-    dst.i64[i] = *reinterpret_cast<__int64 const*>(mem + vindex.i64[i] * scale);
+  std::memcpy(&dst, mem_addr, sizeof(dst));
   return dst;
 }
 
-inline __m512i _mm512_mask_i64gather_epi64(__m512i src, __mmask8 k, __m512i vindex, void const *base_addr, int scale) {
+inline __m512i _mm512_load_epi64(void const *mem_addr) {
+  return _mm512_loadu_si512(mem_addr);
+}
+
+inline __m512i _mm512_load_epi32(void const *mem_addr) {
+  return _mm512_loadu_si512(mem_addr);
+}
+
+inline __m512i _mm512_maskz_loadu_epi64(__mmask8 k, void const *mem_addr) {
   __m512i dst;
-  auto const *mem = static_cast<char const*>(base_addr);
+  auto const *mem = static_cast<char const*>(mem_addr);
   for (auto i = 0; i < 8; i++) {
     if (k & (1 << i))
-      dst.i64[i] = *reinterpret_cast<__int64 const*>(mem + vindex.i64[i] * scale);
+      std::memcpy(&dst.i64[i], mem + i * sizeof(__int64), sizeof(__int64));
     else
-      dst.i64[i] = src.i64[i];
+      dst.i64[i] = 0;
   }
   return dst;
 }
 
-inline void _mm512_i64scatter_epi64(void *base_addr, __m512i vindex, __m512i a, int scale) {
-  // FIXME: base_addr does not need to be aligned on any particular boundary.
-  auto *mem = static_cast<char*>(base_addr);
+inline __m512i _mm512_maskz_load_epi64(__mmask8 k, void const *mem_addr) {
+  return _mm512_maskz_loadu_epi64(k, mem_addr);
+}
+
+inline __m512i _mm512_maskz_loadu_epi32(__mmask16 k, void const *mem_addr) {
+  __m512i dst;
+  auto const *mem = static_cast<char const*>(mem_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      std::memcpy(&dst.i32[i], mem + i * sizeof(std::int32_t), sizeof(std::int32_t));
+    else
+      dst.i32[i] = 0;
+  }
+  return dst;
+}
+
+inline void _mm512_storeu_epi64(void *mem_addr, __m512i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm512_storeu_epi32(void *mem_addr, __m512i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm512_store_epi64(void *mem_addr, __m512i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm512_store_epi32(void *mem_addr, __m512i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm512_mask_storeu_epi64(void *mem_addr, __mmask8 k, __m512i a) {
+  auto *mem = static_cast<char*>(mem_addr);
   for (auto i = 0; i < 8; i++) {
-    *reinterpret_cast<__int64*>(mem + vindex.i64[i] * scale) = a.i64[i];
+    if (k & (1 << i))
+      std::memcpy(mem + i * sizeof(__int64), &a.i64[i], sizeof(__int64));
   }
 }
 
-inline void _mm512_mask_i64scatter_epi64(void *base_addr, __mmask8 k, __m512i vindex, __m512i a, int scale) {
-  // FIXME: base_addr does not need to be aligned on any particular boundary.
-  auto *mem = static_cast<char*>(base_addr);
-  for (auto i = 0; i < 8; i++)
+inline void _mm512_mask_store_epi64(void *mem_addr, __mmask8 k, __m512i a) {
+  _mm512_mask_storeu_epi64(mem_addr, k, a);
+}
+
+inline void _mm512_mask_storeu_epi32(void *mem_addr, __mmask16 k, __m512i a) {
+  auto *mem = static_cast<char*>(mem_addr);
+  for (auto i = 0; i < 16; i++) {
     if (k & (1 << i))
-      *reinterpret_cast<__int64*>(mem + vindex.i64[i] * scale) = a.i64[i];
+      std::memcpy(mem + i * sizeof(std::int32_t), &a.i32[i], sizeof(std::int32_t));
+  }
 }
 
-inline __m512i _mm512_add_epi64(__m512i a, __m512i b) {
-  __m512i dst;
-  for (auto i = 0; i < 8; i++)
-    dst.i64[i] = a.i64[i] + b.i64[i];
+inline __m512i _mm512_maskz_compress_epi64(__mmask8 k, __m512i a) {
+  __m512i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i))
+      dst.i64[j++] = a.i64[i];
+  }
   return dst;
 }
 
-inline __m512i _mm512_sub_epi64(__m512i a, __m512i b) {
-  __m512i dst;
-  for (auto i = 0; i < 8; i++)
-    dst.i64[i] = a.i64[i] - b.i64[i];
+inline __m512i _mm512_maskz_compress_epi32(__mmask16 k, __m512i a) {
+  __m512i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      dst.i32[j++] = a.i32[i];
+  }
   return dst;
 }
 
-inline __m512i _mm512_mullox_epi64(__m512i a, __m512i b) {
-  __m512i dst;
-  for (auto i = 0; i < 8; i++)
-    dst.i64[i] = a.i64[i] * b.i64[i];
+inline __m512i _mm512_maskz_expand_epi64(__mmask8 k, __m512i a) {
+  __m512i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i))
+      dst.i64[i] = a.i64[j++];
+  }
   return dst;
 }
 
-inline __mmask8 _mm512_cmpneq_epu64_mask(__m512i a, __m512i b) {
-  __mmask8 k = 0;
-  for (auto i = 0; i < 8; i++)
-    k |= (a.i64[i] != b.i64[i] ? 1 : 0) << i;
-  return k;
+inline __m512i _mm512_maskz_expand_epi32(__mmask16 k, __m512i a) {
+  __m512i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      dst.i32[i] = a.i32[j++];
+  }
+  return dst;
 }
 
-inline __mmask8 _mm512_cmpeq_epu64_mask(__m512i a, __m512i b) {
+inline __m512i _mm512_maskz_expandloadu_epi32(__mmask16 k, void const *mem_addr) {
+  __m512i dst = {};
+  auto const *mem = static_cast<char const*>(mem_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i)) {
+      std::memcpy(&dst.i32[i], mem, sizeof(std::int32_t));
+      mem += sizeof(std::int32_t);
+    }
+  }
+  return dst;
+}
+
+inline void _mm512_mask_compressstoreu_epi32(void *base_addr, __mmask16 k, __m512i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i)) {
+      std::memcpy(mem, &a.i32[i], sizeof(std::int32_t));
+      mem += sizeof(std::int32_t);
+    }
+  }
+}
+
+inline __m512i _mm512_i64gather_epi64(__m512i vindex, void const *base_addr, int scale) {
+  __m512i dst;
+  auto const *mem = static_cast<char const*>(base_addr);
+  for (auto i = 0; i < 8; i++)
+    std::memcpy(&dst.i64[i], mem + vindex.i64[i] * scale, sizeof(__int64));
+  return dst;
+}
+
+inline __m512i _mm512_mask_i64gather_epi64(__m512i src, __mmask8 k, __m512i vindex, void const *base_addr, int scale) {
+  __m512i dst;
+  auto const *mem = static_cast<char const*>(base_addr);
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i))
+      std::memcpy(&dst.i64[i], mem + vindex.i64[i] * scale, sizeof(__int64));
+    else
+      dst.i64[i] = src.i64[i];
+  }
+  return dst;
+}
+
+inline __m512i _mm512_i32gather_epi32(__m512i vindex, void const *base_addr, int scale) {
+  __m512i dst;
+  auto const *mem = static_cast<char const*>(base_addr);
+  for (auto i = 0; i < 16; i++)
+    std::memcpy(&dst.i32[i], mem + static_cast<std::int64_t>(vindex.i32[i]) * scale, sizeof(std::int32_t));
+  return dst;
+}
+
+inline __m512i _mm512_mask_i32gather_epi32(__m512i src, __mmask16 k, __m512i vindex, void const *base_addr, int scale) {
+  __m512i dst;
+  auto const *mem = static_cast<char const*>(base_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      std::memcpy(&dst.i32[i], mem + static_cast<std::int64_t>(vindex.i32[i]) * scale, sizeof(std::int32_t));
+    else
+      dst.i32[i] = src.i32[i];
+  }
+  return dst;
+}
+
+inline void _mm512_i64scatter_epi64(void *base_addr, __m512i vindex, __m512i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 8; i++)
+    std::memcpy(mem + vindex.i64[i] * scale, &a.i64[i], sizeof(__int64));
+}
+
+inline void _mm512_mask_i64scatter_epi64(void *base_addr, __mmask8 k, __m512i vindex, __m512i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 8; i++)
+    if (k & (1 << i))
+      std::memcpy(mem + vindex.i64[i] * scale, &a.i64[i], sizeof(__int64));
+}
+
+inline void _mm512_i32scatter_epi32(void *base_addr, __m512i vindex, __m512i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 16; i++)
+    std::memcpy(mem + static_cast<std::int64_t>(vindex.i32[i]) * scale, &a.i32[i], sizeof(std::int32_t));
+}
+
+inline void _mm512_mask_i32scatter_epi32(void *base_addr, __mmask16 k, __m512i vindex, __m512i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 16; i++)
+    if (k & (1 << i))
+      std::memcpy(mem + static_cast<std::int64_t>(vindex.i32[i]) * scale, &a.i32[i], sizeof(std::int32_t));
+}
+
+inline __m512i _mm512_add_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] + b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_add_epi32(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u32[i] + b.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_sub_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] - b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_sub_epi32(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u32[i] - b.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mullox_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] * b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mullo_epi32(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u32[i] * b.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_add_epi64(__m512i src, __mmask8 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] + b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_add_epi32(__m512i src, __mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] + b.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_sub_epi64(__m512i src, __mmask8 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] - b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_sub_epi32(__m512i src, __mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] - b.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_or_epi64(__m512i src, __mmask8 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] | b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_or_epi32(__m512i src, __mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] | b.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_xor_epi64(__m512i src, __mmask8 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] ^ b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_xor_epi32(__m512i src, __mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] ^ b.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_mullox_epi64(__m512i src, __mmask8 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] * b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_mullo_epi32(__m512i src, __mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] * b.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_mov_epi64(__m512i src, __mmask8 k, __m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_mov_epi32(__m512i src, __mmask16 k, __m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? a.u32[i] : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mul_epu32(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = static_cast<std::uint64_t>(a.u32[2 * i]) * b.u32[2 * i];
+  return dst;
+}
+
+inline __m512i _mm512_srli_epi64(__m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (imm8 > 63) ? 0 : a.u64[i] >> imm8;
+  return dst;
+}
+
+inline __m512i _mm512_srli_epi32(__m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (imm8 > 31) ? 0 : a.u32[i] >> imm8;
+  return dst;
+}
+
+inline __m512i _mm512_slli_epi64(__m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (imm8 > 63) ? 0 : a.u64[i] << imm8;
+  return dst;
+}
+
+inline __m512i _mm512_slli_epi32(__m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (imm8 > 31) ? 0 : a.u32[i] << imm8;
+  return dst;
+}
+
+inline __m512i _mm512_mask_srli_epi64(__m512i src, __mmask8 k, __m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? ((imm8 > 63) ? 0 : a.u64[i] >> imm8) : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_srli_epi32(__m512i src, __mmask16 k, __m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? ((imm8 > 31) ? 0 : a.u32[i] >> imm8) : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_slli_epi64(__m512i src, __mmask8 k, __m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (k & (1 << i)) ? ((imm8 > 63) ? 0 : a.u64[i] << imm8) : src.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_mask_slli_epi32(__m512i src, __mmask16 k, __m512i a, unsigned int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? ((imm8 > 31) ? 0 : a.u32[i] << imm8) : src.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_srlv_epi64(__m512i a, __m512i count) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = (count.u64[i] > 63) ? 0 : a.u64[i] >> count.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_srlv_epi32(__m512i a, __m512i count) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (count.u32[i] > 31) ? 0 : a.u32[i] >> count.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_and_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] & b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_and_epi32(__m512i a, __m512i b) {
+  return _mm512_and_epi64(a, b);
+}
+
+inline __m512i _mm512_or_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] | b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_or_epi32(__m512i a, __m512i b) {
+  return _mm512_or_epi64(a, b);
+}
+
+inline __m512i _mm512_xor_epi64(__m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] ^ b.u64[i];
+  return dst;
+}
+
+inline __m512i _mm512_xor_epi32(__m512i a, __m512i b) {
+  return _mm512_xor_epi64(a, b);
+}
+
+inline __m512i _mm512_mask_blend_epi32(__mmask16 k, __m512i a, __m512i b) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = (k & (1 << i)) ? b.u32[i] : a.u32[i];
+  return dst;
+}
+
+inline __m512i _mm512_alignr_epi64(__m512i a, __m512i b, int imm8) {
+  // lanes imm8 .. imm8 + 7 of the concatenation a:b.
+  __m512i dst;
+  for (auto i = 0; i < 8; i++) {
+    auto const j = i + (imm8 & 7);
+    dst.u64[i] = j < 8 ? b.u64[j] : a.u64[j - 8];
+  }
+  return dst;
+}
+
+inline __m512i _mm512_alignr_epi32(__m512i a, __m512i b, int imm8) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++) {
+    auto const j = i + (imm8 & 15);
+    dst.u32[i] = j < 16 ? b.u32[j] : a.u32[j - 16];
+  }
+  return dst;
+}
+
+inline __m512i _mm512_permutexvar_epi64(__m512i idx, __m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[idx.u64[i] & 7];
+  return dst;
+}
+
+inline __m512i _mm512_permutexvar_epi32(__m512i idx, __m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = a.u32[idx.u32[i] & 15];
+  return dst;
+}
+
+inline long long _mm512_reduce_add_epi64(__m512i a) {
+  std::uint64_t r = 0;
+  for (auto i = 0; i < 8; i++)
+    r += a.u64[i];
+  return static_cast<long long>(r);
+}
+
+inline long long _mm512_mask_reduce_add_epi64(__mmask8 k, __m512i a) {
+  std::uint64_t r = 0;
+  for (auto i = 0; i < 8; i++)
+    r += (k & (1 << i)) ? a.u64[i] : 0;
+  return static_cast<long long>(r);
+}
+
+inline int _mm512_reduce_add_epi32(__m512i a) {
+  std::uint32_t r = 0;
+  for (auto i = 0; i < 16; i++)
+    r += a.u32[i];
+  return static_cast<int>(r);
+}
+
+inline unsigned long long _mm512_reduce_min_epu64(__m512i a) {
+  auto r = a.u64[0];
+  for (auto i = 1; i < 8; i++)
+    r = a.u64[i] < r ? a.u64[i] : r;
+  return r;
+}
+
+inline unsigned long long _mm512_mask_reduce_min_epu64(__mmask8 k, __m512i a) {
+  auto r = ~std::uint64_t(0);
+  for (auto i = 0; i < 8; i++)
+    r = (k & (1 << i)) && a.u64[i] < r ? a.u64[i] : r;
+  return r;
+}
+
+inline unsigned int _mm512_reduce_min_epu32(__m512i a) {
+  auto r = a.u32[0];
+  for (auto i = 1; i < 16; i++)
+    r = a.u32[i] < r ? a.u32[i] : r;
+  return r;
+}
+
+inline unsigned long long _mm512_reduce_max_epu64(__m512i a) {
+  auto r = a.u64[0];
+  for (auto i = 1; i < 8; i++)
+    r = a.u64[i] > r ? a.u64[i] : r;
+  return r;
+}
+
+inline unsigned long long _mm512_mask_reduce_max_epu64(__mmask8 k, __m512i a) {
+  std::uint64_t r = 0;
+  for (auto i = 0; i < 8; i++)
+    r = (k & (1 << i)) && a.u64[i] > r ? a.u64[i] : r;
+  return r;
+}
+
+inline unsigned int _mm512_reduce_max_epu32(__m512i a) {
+  auto r = a.u32[0];
+  for (auto i = 1; i < 16; i++)
+    r = a.u32[i] > r ? a.u32[i] : r;
+  return r;
+}
+
+inline long long _mm512_reduce_or_epi64(__m512i a) {
+  std::uint64_t r = 0;
+  for (auto i = 0; i < 8; i++)
+    r |= a.u64[i];
+  return static_cast<long long>(r);
+}
+
+inline long long _mm512_mask_reduce_or_epi64(__mmask8 k, __m512i a) {
+  std::uint64_t r = 0;
+  for (auto i = 0; i < 8; i++)
+    r |= (k & (1 << i)) ? a.u64[i] : 0;
+  return static_cast<long long>(r);
+}
+
+inline int _mm512_reduce_or_epi32(__m512i a) {
+  std::uint32_t r = 0;
+  for (auto i = 0; i < 16; i++)
+    r |= a.u32[i];
+  return static_cast<int>(r);
+}
+
+inline __mmask8 _mm512_cmpgt_epu64_mask(__m512i a, __m512i b) {
   __mmask8 k = 0;
   for (auto i = 0; i < 8; i++)
-    k |= (a.i64[i] == b.i64[i] ? 1 : 0) << i;
+    k |= (a.u64[i] > b.u64[i] ? 1 : 0) << i;
   return k;
 }
+
+inline __mmask8 _mm512_cmple_epu64_mask(__m512i a, __m512i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 8; i++)
+    k |= (a.u64[i] <= b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask8 _mm512_cmpneq_epu64_mask(__m512i a, __m512i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 8; i++)
+    k |= (a.u64[i] != b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask8 _mm512_cmpeq_epu64_mask(__m512i a, __m512i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 8; i++)
+    k |= (a.u64[i] == b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask16 _mm512_cmpgt_epu32_mask(__m512i a, __m512i b) {
+  __mmask16 k = 0;
+  for (auto i = 0; i < 16; i++)
+    k |= (a.u32[i] > b.u32[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask16 _mm512_cmple_epu32_mask(__m512i a, __m512i b) {
+  __mmask16 k = 0;
+  for (auto i = 0; i < 16; i++)
+    k |= (a.u32[i] <= b.u32[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask16 _mm512_cmpneq_epu32_mask(__m512i a, __m512i b) {
+  __mmask16 k = 0;
+  for (auto i = 0; i < 16; i++)
+    k |= (a.u32[i] != b.u32[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask16 _mm512_cmpeq_epu32_mask(__m512i a, __m512i b) {
+  __mmask16 k = 0;
+  for (auto i = 0; i < 16; i++)
+    k |= (a.u32[i] == b.u32[i] ? 1 : 0) << i;
+  return k;
+}
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512CD__)
+inline __m512i _mm512_conflict_epi64(__m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++) {
+    dst.u64[i] = 0;
+    for (auto j = 0; j < i; j++)
+      dst.u64[i] |= static_cast<std::uint64_t>(a.u64[i] == a.u64[j]) << j;
+  }
+  return dst;
+}
+
+inline __m512i _mm512_conflict_epi32(__m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++) {
+    dst.u32[i] = 0;
+    for (auto j = 0; j < i; j++)
+      dst.u32[i] |= static_cast<std::uint32_t>(a.u32[i] == a.u32[j]) << j;
+  }
+  return dst;
+}
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+inline __m512i _mm512_popcnt_epi64(__m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = __builtin_popcountll(a.u64[i]);
+  return dst;
+}
+
+inline __m512i _mm512_popcnt_epi32(__m512i a) {
+  __m512i dst;
+  for (auto i = 0; i < 16; i++)
+    dst.u32[i] = __builtin_popcount(a.u32[i]);
+  return dst;
+}
+#endif
+
+#if defined(__AVX512DQ__)
+inline unsigned int _cvtmask8_u32(__mmask8 a) {
+  return a;
+}
+#endif
+
+#if defined(__AVX512VL__)
+inline __m128i _mm256_cvtepi64_epi8(__m256i a) {
+  __m128i dst = {};
+  for (auto i = 0; i < 4; i++)
+    dst.u8[i] = static_cast<std::uint8_t>(a.u64[i]);
+  return dst;
+}
+
+inline void _mm256_mask_cvtepi64_storeu_epi8(void *base_addr, __mmask8 k, __m256i a) {
+  auto *mem = static_cast<std::uint8_t*>(base_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      mem[i] = static_cast<std::uint8_t>(a.u64[i]);
+  }
+}
+
+inline void _mm256_mask_cvtepi64_storeu_epi16(void *base_addr, __mmask8 k, __m256i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i)) {
+      auto const w = static_cast<std::uint16_t>(a.u64[i]);
+      std::memcpy(mem + i * sizeof(w), &w, sizeof(w));
+    }
+  }
+}
+
+inline void _mm256_mask_cvtepi64_storeu_epi32(void *base_addr, __mmask8 k, __m256i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i)) {
+      auto const w = static_cast<std::uint32_t>(a.u64[i]);
+      std::memcpy(mem + i * sizeof(w), &w, sizeof(w));
+    }
+  }
+}
+
+inline __m256i _mm256_load_epi64(void const *mem_addr) {
+  __m256i dst;
+  std::memcpy(&dst, mem_addr, sizeof(dst));
+  return dst;
+}
+
+inline __m256i _mm256_maskz_loadu_epi64(__mmask8 k, void const *mem_addr) {
+  __m256i dst;
+  auto const *mem = static_cast<char const*>(mem_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      std::memcpy(&dst.i64[i], mem + i * sizeof(__int64), sizeof(__int64));
+    else
+      dst.i64[i] = 0;
+  }
+  return dst;
+}
+
+inline void _mm256_storeu_epi64(void *mem_addr, __m256i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm256_store_epi64(void *mem_addr, __m256i a) {
+  std::memcpy(mem_addr, &a, sizeof(a));
+}
+
+inline void _mm256_mask_storeu_epi64(void *mem_addr, __mmask8 k, __m256i a) {
+  auto *mem = static_cast<char*>(mem_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      std::memcpy(mem + i * sizeof(__int64), &a.i64[i], sizeof(__int64));
+  }
+}
+
+inline __m256i _mm256_maskz_compress_epi64(__mmask8 k, __m256i a) {
+  __m256i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      dst.i64[j++] = a.i64[i];
+  }
+  return dst;
+}
+
+inline __m256i _mm256_maskz_expand_epi64(__mmask8 k, __m256i a) {
+  __m256i dst = {};
+  auto j = 0;
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      dst.i64[i] = a.i64[j++];
+  }
+  return dst;
+}
+
+inline __m256i _mm256_maskz_expandloadu_epi32(__mmask8 k, void const *mem_addr) {
+  __m256i dst = {};
+  auto const *mem = static_cast<char const*>(mem_addr);
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i)) {
+      std::memcpy(&dst.i32[i], mem, sizeof(std::int32_t));
+      mem += sizeof(std::int32_t);
+    }
+  }
+  return dst;
+}
+
+inline void _mm256_mask_compressstoreu_epi32(void *base_addr, __mmask8 k, __m256i a) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 8; i++) {
+    if (k & (1 << i)) {
+      std::memcpy(mem, &a.i32[i], sizeof(std::int32_t));
+      mem += sizeof(std::int32_t);
+    }
+  }
+}
+
+inline __m256i _mm256_mmask_i64gather_epi64(__m256i src, __mmask8 k, __m256i vindex, void const *base_addr, int scale) {
+  __m256i dst;
+  auto const *mem = static_cast<char const*>(base_addr);
+  for (auto i = 0; i < 4; i++) {
+    if (k & (1 << i))
+      std::memcpy(&dst.i64[i], mem + vindex.i64[i] * scale, sizeof(__int64));
+    else
+      dst.i64[i] = src.i64[i];
+  }
+  return dst;
+}
+
+inline void _mm256_i64scatter_epi64(void *base_addr, __m256i vindex, __m256i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 4; i++)
+    std::memcpy(mem + vindex.i64[i] * scale, &a.i64[i], sizeof(__int64));
+}
+
+inline void _mm256_mask_i64scatter_epi64(void *base_addr, __mmask8 k, __m256i vindex, __m256i a, int scale) {
+  auto *mem = static_cast<char*>(base_addr);
+  for (auto i = 0; i < 4; i++)
+    if (k & (1 << i))
+      std::memcpy(mem + vindex.i64[i] * scale, &a.i64[i], sizeof(__int64));
+}
+
+inline __m256i _mm256_mask_add_epi64(__m256i src, __mmask8 k, __m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] + b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_sub_epi64(__m256i src, __mmask8 k, __m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] - b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_or_epi64(__m256i src, __mmask8 k, __m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] | b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_xor_epi64(__m256i src, __mmask8 k, __m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] ^ b.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_mov_epi64(__m256i src, __mmask8 k, __m256i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_srli_epi64(__m256i src, __mmask8 k, __m256i a, unsigned int imm8) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? ((imm8 > 63) ? 0 : a.u64[i] >> imm8) : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_slli_epi64(__m256i src, __mmask8 k, __m256i a, unsigned int imm8) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? ((imm8 > 63) ? 0 : a.u64[i] << imm8) : src.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_or_epi64(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] | b.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_xor_epi64(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] ^ b.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_alignr_epi64(__m256i a, __m256i b, int imm8) {
+  // lanes imm8 .. imm8 + 3 of the concatenation a:b.
+  __m256i dst;
+  for (auto i = 0; i < 4; i++) {
+    auto const j = i + (imm8 & 3);
+    dst.u64[i] = j < 4 ? b.u64[j] : a.u64[j - 4];
+  }
+  return dst;
+}
+
+inline __m256i _mm256_permutexvar_epi64(__m256i idx, __m256i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[idx.u64[i] & 3];
+  return dst;
+}
+
+inline __mmask8 _mm256_cmpgt_epu64_mask(__m256i a, __m256i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 4; i++)
+    k |= (a.u64[i] > b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask8 _mm256_cmple_epu64_mask(__m256i a, __m256i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 4; i++)
+    k |= (a.u64[i] <= b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask8 _mm256_cmpneq_epu64_mask(__m256i a, __m256i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 4; i++)
+    k |= (a.u64[i] != b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+
+inline __mmask8 _mm256_cmpeq_epu64_mask(__m256i a, __m256i b) {
+  __mmask8 k = 0;
+  for (auto i = 0; i < 4; i++)
+    k |= (a.u64[i] == b.u64[i] ? 1 : 0) << i;
+  return k;
+}
+#endif
+
+#if defined(__AVX512VL__) && defined(__AVX512DQ__)
+inline __m256i _mm256_mullo_epi64(__m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] * b.u64[i];
+  return dst;
+}
+
+inline __m256i _mm256_mask_mullo_epi64(__m256i src, __mmask8 k, __m256i a, __m256i b) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = (k & (1 << i)) ? a.u64[i] * b.u64[i] : src.u64[i];
+  return dst;
+}
+#endif
+
+#if defined(__AVX512VL__) && defined(__AVX512CD__)
+inline __m256i _mm256_conflict_epi64(__m256i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++) {
+    dst.u64[i] = 0;
+    for (auto j = 0; j < i; j++)
+      dst.u64[i] |= static_cast<std::uint64_t>(a.u64[i] == a.u64[j]) << j;
+  }
+  return dst;
+}
+#endif
+
+#if defined(__AVX512VL__) && defined(__AVX512VPOPCNTDQ__)
+inline __m256i _mm256_popcnt_epi64(__m256i a) {
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = __builtin_popcountll(a.u64[i]);
+  return dst;
+}
+#endif
+
+#if defined(__AVX512IFMA__)
+inline __m512i _mm512_madd52lo_epu64(__m512i a, __m512i b, __m512i c) {
+  auto const lo = (static_cast<std::uint64_t>(1) << 52) - 1;
+  __m512i dst;
+  for (auto i = 0; i < 8; i++)
+    dst.u64[i] = a.u64[i] + (((b.u64[i] & lo) * (c.u64[i] & lo)) & lo);
+  return dst;
+}
+#endif
+
+#if defined(__AVX512IFMA__) && defined(__AVX512VL__)
+inline __m256i _mm256_madd52lo_epu64(__m256i a, __m256i b, __m256i c) {
+  auto const lo = (static_cast<std::uint64_t>(1) << 52) - 1;
+  __m256i dst;
+  for (auto i = 0; i < 4; i++)
+    dst.u64[i] = a.u64[i] + (((b.u64[i] & lo) * (c.u64[i] & lo)) & lo);
+  return dst;
+}
+#endif
+
+#if defined(__AVX512VBMI2__)
+inline __m512i _mm512_maskz_expandloadu_epi8(__mmask64 k, void const *mem_addr) {
+  __m512i dst = {};
+  auto const *mem = static_cast<std::uint8_t const*>(mem_addr);
+  for (auto i = 0; i < 64; i++) {
+    if (k & (static_cast<__mmask64>(1) << i))
+      dst.u8[i] = *mem++;
+  }
+  return dst;
+}
+
+inline void _mm512_mask_compressstoreu_epi8(void *base_addr, __mmask64 k, __m512i a) {
+  auto *mem = static_cast<std::uint8_t*>(base_addr);
+  for (auto i = 0; i < 64; i++) {
+    if (k & (static_cast<__mmask64>(1) << i))
+      *mem++ = a.u8[i];
+  }
+}
+#endif
+
+#if defined(__AVX512VBMI2__) && defined(__AVX512VL__)
+inline __m128i _mm_maskz_expandloadu_epi8(__mmask16 k, void const *mem_addr) {
+  __m128i dst = {};
+  auto const *mem = static_cast<std::uint8_t const*>(mem_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      dst.u8[i] = *mem++;
+  }
+  return dst;
+}
+
+inline void _mm_mask_compressstoreu_epi8(void *base_addr, __mmask16 k, __m128i a) {
+  auto *mem = static_cast<std::uint8_t*>(base_addr);
+  for (auto i = 0; i < 16; i++) {
+    if (k & (1 << i))
+      *mem++ = a.u8[i];
+  }
+}
 #endif
 
 #endif // COMP_CORE_INTERNAL_SIMD_EMU_AVX_H
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_INTERNAL_SIMD_EMU_MARCH_SKYLAKE_AVX512_H
+#define COMP_CORE_INTERNAL_SIMD_EMU_MARCH_SKYLAKE_AVX512_H 1
+
+#define __AVX2__ 1
+#define __AVX512BW__ 1
+#define __AVX512CD__ 1
+#define __AVX512DQ__ 1
+#define __AVX512F__ 1
+#define __AVX512VL__ 1
+#define __AVX__ 1
+#define __SSE2_MATH__ 1
+#define __SSE2__ 1
+#define __SSE3__ 1
+#define __SSE4_1__ 1
+#define __SSE4_2__ 1
+#define __SSE_MATH__ 1
+#define __SSE__ 1
+#define __SSSE3__ 1
+
+#include "core/internal/simd/emu/avx.h"
+
+#endif // COMP_CORE_INTERNAL_SIMD_EMU_MARCH_SKYLAKE_AVX512_H
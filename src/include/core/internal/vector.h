@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_INTERNAL_VECTOR_H
+#define COMP_CORE_INTERNAL_VECTOR_H 1
+
+#include <memory>
+#include <vector>
+
+#include "core/internal/isa.h"
+
+//------------------------------------------------------------------------------
+// containers owned by the library.
+//
+// A std::vector<unitT> instantiated by kernels built for different instruction
+// sets is one type, so the linker keeps a single copy of its members, which
+// may well use instructions the host lacks. Tagging the allocator with the
+// instruction set keeps every copy distinct.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+template <class T>
+class allocator : public std::allocator<T> {
+  public:
+    template <class U>
+    struct rebind { using other = allocator<U>; };
+
+    // Ctors
+    allocator() = default;
+    template <class U>
+    allocator(allocator<U> const &) { }
+};
+
+template <class T>
+using vector = std::vector<T, allocator<T>>;
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_INTERNAL_VECTOR_H
@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_IO_H
+#define COMP_CORE_IO_H 1
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+# include <linux/io_uring.h>
+# include <sys/syscall.h>
+# define COMP_CORE_IO_URING 1
+#endif
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// asynchronous file i/o.
+//
+// An i/o queue takes reads and writes at explicit file offsets, each with a
+// tag of the caller's, and hands back their completions in whatever order they
+// finish, as the tag and the number of bytes moved, or -errno. Either may move
+// fewer bytes than asked, and the caller asks again for the rest. Nothing is
+// started before submit(), and the buffer of an operation is the caller's
+// until its completion is handed back, or cancel() takes it back unstarted.
+//
+// uring_queue goes through io_uring, driven with the raw system calls so no
+// library is needed; ok() is false where the kernel lacks it or has it turned
+// off. blocking_queue runs plain pread() and pwrite() calls on threads of its
+// own, and works everywhere.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! a finished read or write
+struct io_completion {
+  std::uint64_t tag;
+  //! bytes moved, or -errno
+  std::int64_t  res;
+};
+
+//! most bytes one read or write moves, as Linux caps them
+static constexpr std::size_t io_max = 0x7ffff000;
+
+#if defined(COMP_CORE_IO_URING)
+//==============================================================================
+// uring_queue
+//==============================================================================
+class uring_queue {
+  private:
+    int           fd_;
+    unsigned      pending_;
+    void         *sq_;
+    void         *cq_;
+    std::size_t   sq_size_;
+    std::size_t   cq_size_;
+    io_uring_sqe *sqes_;
+    std::size_t   sqes_size_;
+    unsigned     *sq_head_;
+    unsigned     *sq_tail_;
+    unsigned     *sq_mask_;
+    unsigned     *sq_array_;
+    unsigned     *cq_head_;
+    unsigned     *cq_tail_;
+    unsigned     *cq_mask_;
+    io_uring_cqe *cqes_;
+    unsigned      entries_;
+    bool          ok_;
+
+    auto supported() const -> bool;
+    auto push(std::uint8_t const &op, int const &fd, void const *p, std::size_t const &len,
+              std::uint64_t const &at, std::uint64_t const &tag) -> void;
+    auto enter(unsigned const &wait) -> bool;
+
+  public:
+    // Ctors
+    //! A ring for at least entries operations in flight at once.
+    explicit uring_queue(unsigned const &entries);
+    uring_queue(uring_queue const &) = delete;
+    auto operator=(uring_queue const &) -> uring_queue& = delete;
+
+    // Dtor
+    ~uring_queue();
+
+    //! false if io_uring, or its read and write operations, are unavailable
+    auto ok() const -> bool { return ok_; }
+    //! most operations in flight at once; more are not to be queued
+    auto size() const -> std::size_t { return entries_; }
+
+    auto read(int const &fd, byte *p, std::size_t const &len, std::uint64_t const &at,
+              std::uint64_t const &tag) -> void {
+      push(IORING_OP_READ, fd, p, len, at, tag);
+    }
+    auto write(int const &fd, byte const *p, std::size_t const &len, std::uint64_t const &at,
+               std::uint64_t const &tag) -> void {
+      push(IORING_OP_WRITE, fd, p, len, at, tag);
+    }
+
+    //! Start everything queued so far.
+    auto submit() -> bool { return 0 == pending_ || enter(0); }
+    //! Take back everything queued that the kernel has not taken, and return
+    //! how many; what it has taken still completes, even once the ring failed.
+    auto cancel() -> std::size_t;
+    //! Take a completion if there is one.
+    auto poll(io_completion &c) -> bool;
+    //! Take a completion, waiting for one; false if the ring failed.
+    auto wait(io_completion &c) -> bool;
+};
+
+inline uring_queue::uring_queue(unsigned const &entries)
+  : fd_(-1), pending_(0), sq_(MAP_FAILED), cq_(MAP_FAILED), sq_size_(0), cq_size_(0),
+    sqes_(static_cast<io_uring_sqe*>(MAP_FAILED)), sqes_size_(0), sq_head_(nullptr), sq_tail_(nullptr),
+    sq_mask_(nullptr), sq_array_(nullptr), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(nullptr),
+    cqes_(nullptr), entries_(0), ok_(false)
+{
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries ? entries : 1, &p));
+  if (fd_ < 0 || !supported())
+    return;
+
+  sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP)
+    sq_size_ = cq_size_ = sq_size_ < cq_size_ ? cq_size_ : sq_size_;
+
+  sq_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (MAP_FAILED == sq_)
+    return;
+  cq_ = (p.features & IORING_FEAT_SINGLE_MMAP) ? sq_
+      : ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+  if (MAP_FAILED == cq_)
+    return;
+  sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+  sqes_      = static_cast<io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+  if (MAP_FAILED == static_cast<void*>(sqes_))
+    return;
+
+  auto *const sq = static_cast<byte*>(sq_);
+  auto *const cq = static_cast<byte*>(cq_);
+  sq_head_  = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+  sq_tail_  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+  sq_mask_  = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+  cq_head_  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+  cq_tail_  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+  cq_mask_  = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+  cqes_     = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+  // the completion ring holds at least as many entries as the submission
+  // ring, so as long as no more than size() are in flight, none are dropped.
+  entries_ = p.sq_entries;
+  ok_      = true;
+}
+
+inline uring_queue::~uring_queue() {
+  if (MAP_FAILED != static_cast<void*>(sqes_))
+    ::munmap(sqes_, sqes_size_);
+  if (MAP_FAILED != cq_ && cq_ != sq_)
+    ::munmap(cq_, cq_size_);
+  if (MAP_FAILED != sq_)
+    ::munmap(sq_, sq_size_);
+  if (fd_ >= 0)
+    ::close(fd_);
+}
+
+inline auto uring_queue::supported() const -> bool {
+  // IORING_OP_READ and IORING_OP_WRITE are from Linux 5.6, as is the probe.
+  static constexpr unsigned nops = 64;
+  alignas(io_uring_probe) byte buf[sizeof(io_uring_probe) + nops * sizeof(io_uring_probe_op)];
+  std::memset(buf, 0, sizeof(buf));
+
+  auto *const probe = reinterpret_cast<io_uring_probe*>(buf);
+  if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, nops) < 0)
+    return false;
+  return probe->ops_len > IORING_OP_WRITE
+      && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+      && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+}
+
+inline auto uring_queue::push(std::uint8_t const &op, int const &fd, void const *p, std::size_t const &len,
+                              std::uint64_t const &at, std::uint64_t const &tag) -> void {
+  // only this thread moves the tail, and the kernel has taken every entry
+  // before the last submit(), so the slot at the tail is free.
+  auto const tail = *sq_tail_;
+  auto const i    = tail & *sq_mask_;
+
+  auto &e = sqes_[i];
+  std::memset(&e, 0, sizeof(e));
+  e.opcode    = op;
+  e.fd        = fd;
+  e.addr      = reinterpret_cast<std::uintptr_t>(p);
+  e.len       = static_cast<std::uint32_t>(len < io_max ? len : io_max);
+  e.off       = at;
+  e.user_data = tag;
+  sq_array_[i] = i;
+
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  pending_++;
+}
+
+inline auto uring_queue::enter(unsigned const &wait) -> bool {
+  for (;;) {
+    auto const r = ::syscall(__NR_io_uring_enter, fd_, pending_, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                             nullptr, 0);
+    if (r >= 0) {
+      pending_ -= static_cast<unsigned>(r);
+      return true;
+    }
+    if (EINTR != errno && EAGAIN != errno && EBUSY != errno)
+      return false;
+  }
+}
+
+inline auto uring_queue::cancel() -> std::size_t {
+  // without SQPOLL the kernel takes entries only in io_uring_enter(), which
+  // nothing else calls, so the entries past its head stay ours.
+  auto const tail = *sq_tail_;
+  auto const n    = tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  __atomic_store_n(sq_tail_, tail - n, __ATOMIC_RELEASE);
+  pending_ = 0;
+  return n;
+}
+
+inline auto uring_queue::poll(io_completion &c) -> bool {
+  auto const head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+    return false;
+
+  auto const &e = cqes_[head & *cq_mask_];
+  c = { e.user_data, e.res };
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+inline auto uring_queue::wait(io_completion &c) -> bool {
+  while (!poll(c))
+    if (!enter(1))
+      return false;
+  return true;
+}
+#endif // COMP_CORE_IO_URING
+
+//==============================================================================
+// blocking_queue
+//==============================================================================
+class blocking_queue {
+  private:
+    struct request {
+      int           fd;
+      byte         *dst;
+      byte const   *src;
+      std::size_t   len;
+      std::uint64_t at;
+      std::uint64_t tag;
+    };
+
+    std::deque<request, internal::allocator<request>>             todo_;
+    std::deque<io_completion, internal::allocator<io_completion>> done_;
+    internal::vector<std::thread>                                  threads_;
+
+    std::mutex              m_;
+    std::condition_variable todo_cv_;
+    std::condition_variable done_cv_;
+    bool                    stop_;
+
+    auto push(request const &r) -> void {
+      {
+        std::lock_guard<std::mutex> lock(m_);
+        todo_.push_back(r);
+      }
+      todo_cv_.notify_one();
+    }
+    auto work() -> void;
+
+  public:
+    // Ctors
+    //! Start n i/o threads.
+    explicit blocking_queue(unsigned const &n = 2);
+    blocking_queue(blocking_queue const &) = delete;
+    auto operator=(blocking_queue const &) -> blocking_queue& = delete;
+
+    // Dtor
+    ~blocking_queue();
+
+    auto ok() const -> bool { return true; }
+    //! most operations in flight at once; there is no limit
+    auto size() const -> std::size_t { return static_cast<std::size_t>(-1); }
+
+    auto read(int const &fd, byte *p, std::size_t const &len, std::uint64_t const &at,
+              std::uint64_t const &tag) -> void {
+      push({ fd, p, nullptr, len, at, tag });
+    }
+    auto write(int const &fd, byte const *p, std::size_t const &len, std::uint64_t const &at,
+               std::uint64_t const &tag) -> void {
+      push({ fd, nullptr, p, len, at, tag });
+    }
+
+    //! Operations start as they are queued.
+    auto submit() -> bool { return true; }
+    //! Take back everything queued that no thread has started, and return
+    //! how many.
+    auto cancel() -> std::size_t;
+    //! Take a completion if there is one.
+    auto poll(io_completion &c) -> bool;
+    //! Take a completion, waiting for one.
+    auto wait(io_completion &c) -> bool;
+};
+
+inline blocking_queue::blocking_queue(unsigned const &n) : stop_(false) {
+  for (unsigned i = 0; i < (n ? n : 1); i++)
+    threads_.emplace_back([this] { work(); });
+}
+
+inline blocking_queue::~blocking_queue() {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    stop_ = true;
+  }
+  todo_cv_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+}
+
+inline auto blocking_queue::work() -> void {
+  for (;;) {
+    request r;
+    {
+      std::unique_lock<std::mutex> lock(m_);
+      todo_cv_.wait(lock, [this] { return stop_ || !todo_.empty(); });
+      if (todo_.empty())
+        return;
+      r = todo_.front();
+      todo_.pop_front();
+    }
+
+    auto const len = r.len < io_max ? r.len : io_max;
+    auto const at  = static_cast<off_t>(r.at);
+    ssize_t res;
+    do {
+      res = r.dst ? ::pread(r.fd, r.dst, len, at) : ::pwrite(r.fd, r.src, len, at);
+    } while (res < 0 && EINTR == errno);
+    std::int64_t const v = res < 0 ? -static_cast<std::int64_t>(errno) : res;
+
+    {
+      std::lock_guard<std::mutex> lock(m_);
+      done_.push_back({ r.tag, v });
+    }
+    done_cv_.notify_one();
+  }
+}
+
+inline auto blocking_queue::cancel() -> std::size_t {
+  std::lock_guard<std::mutex> lock(m_);
+  auto const n = todo_.size();
+  todo_.clear();
+  return n;
+}
+
+inline auto blocking_queue::poll(io_completion &c) -> bool {
+  std::lock_guard<std::mutex> lock(m_);
+  if (done_.empty())
+    return false;
+  c = done_.front();
+  done_.pop_front();
+  return true;
+}
+
+inline auto blocking_queue::wait(io_completion &c) -> bool {
+  std::unique_lock<std::mutex> lock(m_);
+  done_cv_.wait(lock, [this] { return !done_.empty(); });
+  c = done_.front();
+  done_.pop_front();
+  return true;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_IO_H
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_LOOKUP_H
+#define COMP_CORE_LOOKUP_H 1
+
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// slot to symbol lookup.
+//
+// Every slot of a frequency table normalized to 2^bits owns one unit, packed as
+//
+//   | cumfreq | freq - 1 | symbol |
+//
+// with the symbol in the low sym_width bits and the remaining bits split
+// evenly between the other two fields, so one gather resolves all three for
+// every lane. freq - 1 is stored so that a single symbol owning all slots
+// still fits.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Symbol, frequency and cumulative frequency of a slot, one per lane.
+template <class dataT>
+struct slot_entry {
+  dataT sym;
+  dataT frq;
+  dataT cum;
+};
+
+//! Slot to (symbol, freq, cumfreq) table for symbols of type symbT.
+template <class dataT, class symbT = byte>
+class lookup {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+
+  public:
+    static constexpr int sym_width  = static_cast<int>(sizeof(symbT) * CHAR_BIT);
+    static constexpr int frq_width  = (data_traits<dataT>::unit_width - sym_width) / 2;
+    //! largest supported precision of the frequency table
+    static constexpr int max_bits   = frq_width < 16 ? frq_width : 16;
+
+    static_assert(std::is_unsigned<symbT>::value, "symbT must be unsigned");
+    static_assert(8 <= frq_width, "symbT too wide for the unit type");
+
+  private:
+    internal::vector<unitT> tab_;
+
+  public:
+    // Ctors
+    //! f holds the frequency of each symbol, summing to 2^bits with
+    //! bits in [0, max_bits]. Throws std::invalid_argument if bits is out of
+    //! range.
+    template < template <class, class> class contT
+             , class alocT >
+    lookup(contT<freq, alocT> const &f, int const &bits);
+
+    //! Resolve the slot of every lane.
+    auto operator()(dataT const &slot) const -> slot_entry<dataT>;
+
+    auto data() const -> unitT const* { return tab_.data(); }
+    auto size() const -> std::size_t { return tab_.size(); }
+};
+
+template <class dataT, class symbT>
+template < template <class, class> class contT
+         , class alocT >
+inline lookup<dataT, symbT>::lookup(contT<freq, alocT> const &f, int const &bits)
+{
+  if (bits < 0 || bits > max_bits)
+    throw std::invalid_argument("lookup: bits out of range");
+  tab_.resize(static_cast<std::size_t>(1) << bits);
+
+  unitT c = 0;
+  for (std::size_t s = 0; s < f.size(); s++) {
+    auto const fs = static_cast<unitT>(f[s]);
+    if (0 == fs)
+      continue;
+
+    auto const e = (c << (sym_width + frq_width))
+                 | ((fs - 1) << sym_width)
+                 | static_cast<unitT>(s);
+    for (unitT i = 0; i < fs; i++)
+      tab_[c + i] = e;
+    c += fs;
+  }
+}
+
+template <class dataT, class symbT>
+inline auto lookup<dataT, symbT>::operator()(dataT const &slot) const -> slot_entry<dataT> {
+  auto const e = abi::gather(static_cast<baseT>(slot), tab_.data());
+
+  auto const sym = abi::land(e, abi::set((static_cast<unitT>(1) << sym_width) - 1));
+  auto const frq = abi::bsrm(e, sym_width, abi::set((static_cast<unitT>(1) << frq_width) - 1));
+  auto const cum = abi::bsr(e, sym_width + frq_width);
+
+  return { dataT(sym), dataT(abi::add(frq, abi::set(1))), dataT(cum) };
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_LOOKUP_H
@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_MMAP_H
+#define COMP_CORE_MMAP_H 1
+
+#include <cstddef>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/internal/isa.h"
+#include "container.h"
+#include "thread_pool.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// memory mapped files.
+//
+// The input of a codec is mapped read-only and handed to it as is, so nothing
+// is read into a buffer first. Output goes to a caller's buffer, or to a file
+// that is sized for the worst case, mapped, and cut down to what was written
+// once it is complete. Both are walked front to back, so they are advised as
+// sequential, and the pages behind the window of blocks in flight are dropped
+// with MADV_DONTNEED as soon as every block in them is done, each page once,
+// so the work does not grow with the part already done. Dropping a page of a
+// shared mapping keeps its data, which the kernel writes back as usual, so the
+// resident set stays bounded by the window, whatever the size of the file.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! A whole regular file mapped read-only into memory.
+class mapped_file {
+  protected:
+    int         fd_;
+    byte       *p_;
+    std::size_t size_;
+    //! pages before this have been released by release_to()
+    std::size_t dropped_;
+    bool        ok_;
+
+    auto map(int const &prot, int const &flags) -> void {
+      // an empty file cannot be mapped, and need not be.
+      if (0 == size_) {
+        ok_ = true;
+        return;
+      }
+      auto *const m = ::mmap(nullptr, size_, prot, flags, fd_, 0);
+      if (MAP_FAILED == m)
+        return;
+      p_  = static_cast<byte*>(m);
+      ok_ = true;
+      ::madvise(p_, size_, MADV_SEQUENTIAL);
+    }
+
+    mapped_file(int const &fd, std::size_t const &size)
+      : fd_(fd), p_(nullptr), size_(size), dropped_(0), ok_(false) { }
+
+  public:
+    // Ctors
+    //! Map the file at path read-only. Anything but a regular file, whose
+    //! size is not known up front, is not mapped.
+    explicit mapped_file(char const *path) : mapped_file(::open(path, O_RDONLY), 0) {
+      struct stat st;
+      if (fd_ < 0 || 0 != ::fstat(fd_, &st) || !S_ISREG(st.st_mode))
+        return;
+      size_ = static_cast<std::size_t>(st.st_size);
+      map(PROT_READ, MAP_PRIVATE);
+    }
+    mapped_file(mapped_file const &) = delete;
+    auto operator=(mapped_file const &) -> mapped_file& = delete;
+
+    // Dtor
+    ~mapped_file() {
+      if (p_)
+        ::munmap(p_, size_);
+      if (fd_ >= 0)
+        ::close(fd_);
+    }
+
+    //! false if the file could not be opened or mapped
+    auto ok() const -> bool { return ok_; }
+
+    auto data() const -> byte const* { return p_; }
+    auto size() const -> std::size_t { return size_; }
+
+    //! Drop the whole pages within [off, off + len) from the resident set. A
+    //! later access faults them back in from the file.
+    auto release(std::size_t const &off, std::size_t const &len) -> void {
+      auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+      auto const lo   = (off + page - 1) / page * page;
+      auto const hi   = (off + len) / page * page;
+      if (p_ && lo < hi)
+        ::madvise(p_ + lo, hi - lo, MADV_DONTNEED);
+    }
+
+    //! Drop the whole pages before byte n that no earlier call has, so that a
+    //! walk from front to back releases every page once, however many calls
+    //! it takes.
+    auto release_to(std::size_t const &n) -> void {
+      auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+      auto const hi   = n / page * page;
+      if (dropped_ < hi) {
+        release(dropped_, hi - dropped_);
+        dropped_ = hi;
+      }
+    }
+};
+
+//! A file created with a given size and mapped for reading and writing.
+class mapped_output : public mapped_file {
+  public:
+    // Ctors
+    //! Create the file at path, or truncate it, with size bytes and map it for
+    //! reading and writing.
+    mapped_output(char const *path, std::size_t const &size)
+      : mapped_file(::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644), size)
+    {
+      if (fd_ < 0 || 0 != ::ftruncate(fd_, static_cast<off_t>(size_)))
+        return;
+      map(PROT_READ | PROT_WRITE, MAP_SHARED);
+    }
+
+    using mapped_file::data;
+    auto data() -> byte* { return p_; }
+
+    //! Cut the file down to n bytes, with n <= size(); the mapping is kept.
+    auto truncate(std::size_t const &n) -> bool {
+      return 0 == ::ftruncate(fd_, static_cast<off_t>(n));
+    }
+};
+
+//! Write the container of the mapped file in into out, which must hold
+//! container_writer<dataT>(pool, block).bound(in.size()) bytes, dropping the
+//! pages of in behind the window, and return its size.
+template <class dataT>
+inline auto compress(thread_pool &pool, mapped_file &in, byte *out,
+                     std::size_t const &block = container_writer<dataT>::default_block,
+                     int const &bits = container_writer<dataT>::default_bits) -> std::size_t {
+  container_writer<dataT> const w(pool, block, bits);
+  return w.encode(in.data(), in.size(), out, [&](std::size_t const &read, std::size_t const &) {
+    in.release_to(read);
+  });
+}
+
+//! Write the container of the file at src to the file at dst, with a bounded
+//! resident set, and return false if either could not be mapped.
+template <class dataT>
+inline auto compress(thread_pool &pool, char const *src, char const *dst,
+                     std::size_t const &block = container_writer<dataT>::default_block,
+                     int const &bits = container_writer<dataT>::default_bits) -> bool {
+  mapped_file in(src);
+  if (!in.ok())
+    return false;
+
+  container_writer<dataT> const w(pool, block, bits);
+  mapped_output out(dst, w.bound(in.size()));
+  if (!out.ok())
+    return false;
+
+  auto const size = w.encode(in.data(), in.size(), out.data(),
+    [&](std::size_t const &read, std::size_t const &written) {
+      in.release_to(read);
+      out.release_to(written);
+    });
+  return out.truncate(size);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+
+namespace internal {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Decode r into out a window of blocks at a time, calling done(read,
+//! written) after each with the bytes of the container read and the symbols
+//! written so far. Returns false as soon as a window fails to decode.
+template <class dataT, class fnT>
+inline auto decode_windows(thread_pool &pool, container_reader<dataT> const &r, std::size_t const &size,
+                           byte *out, fnT const &done) -> bool {
+  auto const nb     = r.blocks();
+  auto const window = 4 * (pool.size() + 1);
+
+  for (std::size_t first = 0; first < nb; first += window) {
+    auto const last = nb - first < window ? nb : first + window;
+    auto const pos  = r.offset(first);
+    auto const end  = last < nb ? r.offset(last) : r.size();
+    if (!r.decode(pool, pos, end - pos, out + pos))
+      return false;
+    done(last < nb ? r.start(last) : size, end);
+  }
+  return true;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace internal
+
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Decode the container in the mapped file in into out, which must hold
+//! every symbol, dropping the pages of in behind the window. Returns false if
+//! in is not a container written with dataT, or is corrupt.
+template <class dataT>
+inline auto decompress(thread_pool &pool, mapped_file &in, byte *out) -> bool {
+  container_reader<dataT> const r(in.data(), in.size());
+  if (!r.ok())
+    return false;
+
+  return internal::decode_windows(pool, r, in.size(), out, [&](std::size_t const &read, std::size_t const &) {
+    in.release_to(read);
+  });
+}
+
+//! Decode the container in the file at src into the file at dst, with a
+//! bounded resident set. Returns false if either could not be mapped, or src
+//! is not a container written with dataT, or is corrupt.
+template <class dataT>
+inline auto decompress(thread_pool &pool, char const *src, char const *dst) -> bool {
+  mapped_file in(src);
+  if (!in.ok())
+    return false;
+
+  container_reader<dataT> const r(in.data(), in.size());
+  if (!r.ok())
+    return false;
+
+  mapped_output out(dst, r.size());
+  if (!out.ok())
+    return false;
+
+  return internal::decode_windows(pool, r, in.size(), out.data(),
+    [&](std::size_t const &read, std::size_t const &written) {
+      in.release_to(read);
+      out.release_to(written);
+    });
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_MMAP_H
@@ -0,0 +1,451 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_ORDER1_H
+#define COMP_CORE_ORDER1_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "lookup.h"
+#include "rans.h"
+#include "stream.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// order-1 rANS.
+//
+// Every symbol is coded with the frequencies of the context of the symbol
+// before it. So that a lane always has that symbol at hand, the input is cut
+// into one contiguous segment per lane, each lane codes its own segment, and
+// the previous vector of symbols is the context of the next. Segments are
+// equally long, the last ones padded by repeating their last symbol, which is
+// counted like any other so it stays codeable.
+//
+// A dense table of 256 x 256 frequencies would not fit in L2. Instead every
+// context lists only the symbols it has, in symbol order, in a run of
+// entries packed as lookup<> packs a slot,
+//
+//   | cumfreq | freq - 1 | symbol |
+//
+// so one unit answers for all three and the precision is that of lookup<>,
+// 12 bits with 32-bit units and 16 with 64-bit units. A run is padded to a
+// power of two by repeating its last entry, and one more table, indexed by
+// context, holds where each run starts and how long it is. A lookup is a
+// gather keyed by the previous symbols, then a binary search within the runs,
+// one gather per step for all lanes: by symbol to encode, by slot to decode.
+// Sparse contexts have short runs, which take few steps and little memory.
+//
+// The stored table lists the symbols of a context with few of them and marks
+// them in a bitmap otherwise, followed by their frequencies; contexts that
+// never occur are not stored at all.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! number of contexts of an order-1 model over byte symbols
+static constexpr std::size_t order1_contexts = 256;
+//! largest number of bytes of a stored order-1 table
+static constexpr std::size_t order1_table_bound = 32 + order1_contexts * (1 + 32 + 2 * 256);
+
+//! Scale every context of an order-1 table of pair counts, see normalize().
+template < template <class, class> class contT
+         , class alocT >
+inline auto normalize_order1(contT<freq, alocT> &f, int const &bits) -> void {
+  internal::vector<freq> g(256);
+  for (std::size_t c = 0; c < order1_contexts; c++) {
+    auto *const p = f.data() + c * 256;
+    std::memcpy(g.data(), p, 256 * sizeof(freq));
+    normalize(g, bits);
+    std::memcpy(p, g.data(), 256 * sizeof(freq));
+  }
+}
+
+//! Store an order-1 table normalized to 2^bits with bits <= 16 and return the
+//! end of it, at most order1_table_bound bytes on.
+template < template <class, class> class contT
+         , class alocT >
+inline auto put_order1_table(contT<freq, alocT> const &f, byte *out) -> byte* {
+  // a symbol list is cheaper than a bitmap up to this many symbols.
+  static constexpr std::size_t sparse = 32;
+
+  byte used[32] = {};
+  for (std::size_t c = 0; c < order1_contexts; c++)
+    for (std::size_t s = 0; s < 256; s++)
+      if (f[c * 256 + s])
+        used[c / 8] |= static_cast<byte>(1u << (c % 8));
+  std::memcpy(out, used, sizeof(used));
+  auto *p = out + sizeof(used);
+
+  for (std::size_t c = 0; c < order1_contexts; c++) {
+    if (!(used[c / 8] & (1u << (c % 8))))
+      continue;
+
+    auto const *const g = f.data() + c * 256;
+    std::size_t k = 0;
+    for (std::size_t s = 0; s < 256; s++)
+      k += g[s] ? 1 : 0;
+
+    *p++ = static_cast<byte>(k - 1);
+    if (k < sparse) {
+      for (std::size_t s = 0; s < 256; s++)
+        if (g[s])
+          *p++ = static_cast<byte>(s);
+    } else {
+      std::memset(p, 0, 32);
+      for (std::size_t s = 0; s < 256; s++)
+        if (g[s])
+          p[s / 8] |= static_cast<byte>(1u << (s % 8));
+      p += 32;
+    }
+
+    // freq - 1, so that one symbol owning all of 2^16 fits.
+    for (std::size_t s = 0; s < 256; s++) {
+      if (g[s]) {
+        auto const w = static_cast<std::uint16_t>(g[s] - 1);
+        std::memcpy(p, &w, sizeof(w));
+        p += sizeof(w);
+      }
+    }
+  }
+  return p;
+}
+
+//! Load a table stored by put_order1_table() from the size bytes at in into
+//! f, which must hold order1_contexts * 256 entries, and return the end of the
+//! table. Returns nullptr if the table would run past in, or a context it
+//! stores does not sum to 2^bits, in which case f holds garbage.
+template < template <class, class> class contT
+         , class alocT >
+inline auto get_order1_table(byte const *in, std::size_t const &size, int const &bits,
+                             contT<freq, alocT> &f) -> byte const* {
+  static constexpr std::size_t sparse = 32;
+
+  for (std::size_t i = 0; i < order1_contexts * 256; i++)
+    f[i] = 0;
+
+  byte used[32];
+  if (size < sizeof(used))
+    return nullptr;
+  std::memcpy(used, in, sizeof(used));
+
+  auto const *p   = in + sizeof(used);
+  auto const *end = in + size;
+
+  byte syms[256];
+  for (std::size_t c = 0; c < order1_contexts; c++) {
+    if (!(used[c / 8] & (1u << (c % 8))))
+      continue;
+
+    if (end - p < 1)
+      return nullptr;
+    std::size_t const k = static_cast<std::size_t>(*p++) + 1;
+
+    // the symbols, in increasing order, then a frequency for each.
+    if (k < sparse) {
+      if (static_cast<std::size_t>(end - p) < k)
+        return nullptr;
+      std::memcpy(syms, p, k);
+      p += k;
+      for (std::size_t i = 1; i < k; i++)
+        if (syms[i] <= syms[i - 1])
+          return nullptr;
+    } else {
+      if (end - p < 32)
+        return nullptr;
+      std::size_t i = 0;
+      for (std::size_t s = 0; s < 256; s++)
+        if (p[s / 8] & (1u << (s % 8)))
+          syms[i++] = static_cast<byte>(s);
+      p += 32;
+      if (i != k)
+        return nullptr;
+    }
+
+    if (static_cast<std::size_t>(end - p) < 2 * k)
+      return nullptr;
+
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < k; i++) {
+      std::uint16_t w;
+      std::memcpy(&w, p, sizeof(w));
+      p += sizeof(w);
+      f[c * 256 + syms[i]] = static_cast<freq>(w) + 1;
+      sum += static_cast<std::size_t>(w) + 1;
+    }
+    if (sum != static_cast<std::size_t>(1) << bits)
+      return nullptr;
+  }
+  return p;
+}
+
+//! Interleaved order-1 rANS coder for byte symbols, one segment of the input
+//! per lane of dataT.
+template <class dataT>
+class order1_rans {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    static constexpr auto half  = data_traits<dataT>::unit_width / 2;
+
+    static constexpr int sym_width = lookup<dataT>::sym_width;
+    static constexpr int frq_width = lookup<dataT>::frq_width;
+
+  public:
+    //! number of distinct symbols
+    static constexpr std::size_t alphabet = 256;
+    //! lower bound of a coder state
+    static constexpr unitT lower = static_cast<unitT>(1) << 23;
+    //! supported range of the frequency table precision
+    static constexpr int min_bits = 8;
+    static constexpr int max_bits = lookup<dataT>::max_bits;
+
+  private:
+    int bits_;
+    //! longest run of any context
+    unitT cap_;
+    //! start of the run of every context in the lower half of the unit, its
+    //! length in the upper half
+    internal::vector<unitT> ctx_;
+    //! the runs, then cap_ entries of slack for the search to overrun into
+    internal::vector<unitT> tab_;
+
+    static auto segment(std::size_t const &n) -> std::size_t { return (n + arity - 1) / arity; }
+    //! Cut in into segments, one per lane, laid out a vector at a time.
+    static auto transpose(byte const *in, std::size_t const &n, byte *out) -> void;
+
+    //! Entry of every lane, found in the run of its previous symbol as the
+    //! last whose (e >> shift) & mask does not exceed its key.
+    auto find(baseT const &prev, baseT const &key, int const &shift, unitT const &mask) const -> baseT;
+
+  public:
+    // Ctors
+    //! f must hold order1_contexts runs of alphabet frequencies, every run
+    //! summing to 2^bits or 0, with bits in [min_bits, max_bits], see
+    //! normalize_order1(). Throws std::invalid_argument if bits is out of
+    //! range.
+    template < template <class, class> class contT
+             , class alocT >
+    order1_rans(contT<freq, alocT> const &f, int const &bits);
+
+    //! Add the number of occurrences of every (previous, symbol) pair of
+    //! in[0..n), as the coder sees them, to f[previous * alphabet + symbol].
+    template < template <class, class> class contT
+             , class alocT >
+    static auto histogram(byte const *in, std::size_t const &n, contT<freq, alocT> &f) -> void;
+
+    //! Upper bound on the encoded size of n symbols.
+    static auto bound(std::size_t const &n) -> std::size_t {
+      return 2 * (n + arity) + 4 * arity + arity;
+    }
+
+    //! Bytes of the tables a lookup touches.
+    auto table_bytes() const -> std::size_t { return (ctx_.size() + tab_.size()) * sizeof(unitT); }
+
+    //! Encode n symbols into out, which must hold bound(n) bytes, and return
+    //! the number of bytes written.
+    auto encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t;
+    //! Decode n symbols from the size bytes at in, which must be the output of
+    //! encode(). Returns false if in is found to be truncated or corrupt, as
+    //! rans<>::decode().
+    auto decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool;
+};
+
+template <class dataT>
+template < template <class, class> class contT
+         , class alocT >
+inline order1_rans<dataT>::order1_rans(contT<freq, alocT> const &f, int const &bits)
+  : bits_(bits), cap_(1), ctx_(order1_contexts)
+{
+  if (bits < min_bits || bits > max_bits)
+    throw std::invalid_argument("order1_rans: bits out of range");
+
+  // every run as long as the next power of two, and where it starts.
+  unitT size = 0;
+  for (std::size_t c = 0; c < order1_contexts; c++) {
+    unitT k = 0;
+    for (std::size_t s = 0; s < alphabet; s++)
+      k += f[c * alphabet + s] ? 1 : 0;
+
+    unitT cap = 1;
+    while (cap < k)
+      cap <<= 1;
+    ctx_[c] = (cap << half) | size;
+    cap_    = cap_ < cap ? cap : cap_;
+    size   += cap;
+  }
+
+  tab_.resize(size + cap_);
+  for (std::size_t c = 0; c < order1_contexts; c++) {
+    auto *const run = tab_.data() + (ctx_[c] & ((static_cast<unitT>(1) << half) - 1));
+    auto const  cap = ctx_[c] >> half;
+
+    unitT i = 0, cum = 0;
+    for (std::size_t s = 0; s < alphabet; s++) {
+      auto const fs = static_cast<unitT>(f[c * alphabet + s]);
+      if (0 == fs)
+        continue;
+      run[i++] = (cum << (sym_width + frq_width)) | ((fs - 1) << sym_width) | static_cast<unitT>(s);
+      cum += fs;
+    }
+    // a context that never occurs keeps a single, harmless entry.
+    for (auto const last = i ? run[i - 1] : 0; i < cap; i++)
+      run[i] = last;
+  }
+}
+
+template <class dataT>
+template < template <class, class> class contT
+         , class alocT >
+inline auto order1_rans<dataT>::histogram(byte const *in, std::size_t const &n, contT<freq, alocT> &f) -> void {
+  auto const seg = segment(n);
+  for (std::size_t j = 0; j < arity; j++) {
+    std::size_t prev = 0;
+    for (std::size_t t = 0; t < seg; t++) {
+      auto const i = j * seg + t;
+      std::size_t const s = i < n ? in[i] : prev;
+      f[prev * alphabet + s]++;
+      prev = s;
+    }
+  }
+}
+
+template <class dataT>
+inline auto order1_rans<dataT>::transpose(byte const *in, std::size_t const &n, byte *out) -> void {
+  auto const seg = segment(n);
+  for (std::size_t j = 0; j < arity; j++) {
+    byte prev = 0;
+    for (std::size_t t = 0; t < seg; t++) {
+      auto const i = j * seg + t;
+      prev = i < n ? in[i] : prev;
+      out[t * arity + j] = prev;
+    }
+  }
+}
+
+template <class dataT>
+inline auto order1_rans<dataT>::find(baseT const &prev, baseT const &key, int const &shift,
+                                     unitT const &mask) const -> baseT {
+  auto const lo  = abi::set((static_cast<unitT>(1) << half) - 1);
+  auto const fld = abi::set(mask);
+
+  auto const ce  = abi::gather(prev, ctx_.data());
+  auto const off = abi::land(ce, lo);
+  auto const cap = abi::bsr(ce, half);
+
+  // steps past the end of a shorter run read the slack, and are masked off.
+  auto i = abi::set(0);
+  for (auto step = cap_ >> 1; step; step >>= 1) {
+    auto const t = abi::add(i, abi::set(step));
+    auto const e = abi::gather(abi::add(off, t), tab_.data());
+    auto const v = abi::bsrm(e, shift, fld);
+    auto const k = static_cast<maskT>(abi::cmpgt(cap, t) & abi::cmple(v, key));
+    i = abi::madd(k, i, abi::set(step));
+  }
+  return abi::gather(abi::add(off, i), tab_.data());
+}
+
+template <class dataT>
+inline auto order1_rans<dataT>::encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t {
+  auto const seg = segment(n);
+
+  internal::vector<byte> tmp(seg * arity);
+  transpose(in, n, tmp.data());
+
+  reverse_stream<dataT> os(out, bound(n));
+
+  auto x = abi::set(lower);
+  for (auto t = seg; t-- > 0;) {
+    auto const s    = abi::get(tmp.data() + t * arity);
+    auto const prev = t ? abi::get(tmp.data() + (t - 1) * arity) : abi::set(0);
+    auto const e    = find(prev, s, 0, (static_cast<unitT>(1) << sym_width) - 1);
+    auto const f    = abi::add(abi::bsrm(e, sym_width, abi::set((static_cast<unitT>(1) << frq_width) - 1)),
+                               abi::set(1));
+    auto const c    = abi::bsr(e, sym_width + frq_width);
+
+    // shift out the low bytes of every lane that would overflow.
+    auto const xm = abi::bsl(f, 31 - bits_);
+    for (maskT k; (k = abi::cmple(xm, x));) {
+      os.masked_write(dataT(x), k);
+      x = abi::mbsr(k, x, 8);
+    }
+
+    // with a table per context, reciprocals would cost more memory than the
+    // division they save.
+    baseT r;
+    auto const q = abi::divmod(x, f, r);
+    x = abi::add(abi::bsl(q, bits_), abi::add(r, c));
+  }
+
+  // flush the full states, lowest byte last.
+  for (int i = 0; i < 4; i++) {
+    os.write(dataT(x));
+    x = abi::bsr(x, 8);
+  }
+
+  auto const size = static_cast<std::size_t>(out + bound(n) - os.pos());
+  std::memmove(out, os.pos(), size);
+  return size;
+}
+
+template <class dataT>
+inline auto order1_rans<dataT>::decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool {
+  auto const seg = segment(n);
+  auto const m   = static_cast<unitT>(1) << bits_;
+
+  internal::vector<byte> tmp(seg * arity);
+  bounded_stream<dataT> is(in, size);
+
+  auto x = abi::set(0);
+  for (int i = 0; i < 4; i++) {
+    dataT b(abi::set(0));
+    is.read(b);
+    x = abi::lor(abi::bsl(x, 8), static_cast<baseT>(b));
+  }
+
+  auto prev = abi::set(0);
+  for (std::size_t t = 0; t < seg; t++) {
+    auto const slot = abi::land(x, abi::set(m - 1));
+    auto const e    = find(prev, slot, sym_width + frq_width, static_cast<unitT>(-1));
+    auto const s    = abi::land(e, abi::set((static_cast<unitT>(1) << sym_width) - 1));
+    auto const f    = abi::add(abi::bsrm(e, sym_width, abi::set((static_cast<unitT>(1) << frq_width) - 1)),
+                               abi::set(1));
+    auto const c    = abi::bsr(e, sym_width + frq_width);
+
+    abi::put(tmp.data() + t * arity, s);
+    prev = s;
+    x    = abi::muladd52(f, abi::bsr(x, bits_), abi::sub(slot, c));
+
+    // as rans<>, count the bytes of every lane, then read the groups back.
+    maskT k[4];
+    int u = 0;
+    for (auto z = x; u < 4 && (k[u] = abi::cmpgt(abi::set(lower), z)); u++)
+      z = abi::mbsl(k[u], z, 8);
+    while (u--) {
+      dataT b(abi::set(0));
+      is.masked_read(b, k[u]);
+      x = abi::lor(abi::mbsl(k[u], x, 8), static_cast<baseT>(b));
+    }
+  }
+
+  for (std::size_t j = 0; j < arity; j++)
+    for (std::size_t t = 0; t < seg && j * seg + t < n; t++)
+      out[j * seg + t] = tmp[t * arity + j];
+
+  // every lane ends where the encoder started it, unless in is corrupt.
+  return is.ok() && abi::mask_max == abi::cmpeq(x, abi::set(lower));
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_ORDER1_H
@@ -0,0 +1,288 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_PARALLEL_H
+#define COMP_CORE_PARALLEL_H 1
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "histogram.h"
+#include "rans.h"
+#include "thread_pool.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// block-parallel rANS.
+//
+// The input is cut into fixed-size blocks, each coded on its own with a table
+// built from its own histogram, so every block is a task of its own:
+//
+//   | n (8) | block (4) | bits (1) | size of each block (4 each) | blocks |
+//
+// where a block is its stored frequency table followed by its rANS bytes, and
+// its size counts both. Encoding codes every block into a slot of bound size,
+// sums the sizes up into offsets, then moves the blocks next to each other.
+// Decoding checks the header and the sizes against the length of its input,
+// sums the sizes up to find every block and decodes them all at once. A block
+// must be decoded with the data type it was encoded with.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Replace a[0..n) by its exclusive prefix sum, in runs of at least grain
+//! values per task, and return the total.
+template <class T>
+inline auto exclusive_scan(thread_pool &pool, T *a, std::size_t const &n,
+                           std::size_t const &grain = 4096) -> T {
+  auto const runs = n / grain < pool.size() + 1 ? n / grain : pool.size() + 1;
+
+  if (runs <= 1) {
+    T sum = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      auto const v = a[i];
+      a[i] = sum;
+      sum += v;
+    }
+    return sum;
+  }
+
+  // sum every run, scan the sums, then scan every run from its own start.
+  internal::vector<T> part(runs);
+  pool.parallel_for(runs, [&](std::size_t const &r) {
+    T sum = 0;
+    for (auto i = n * r / runs; i < n * (r + 1) / runs; i++)
+      sum += a[i];
+    part[r] = sum;
+  });
+
+  T sum = 0;
+  for (auto &p : part) {
+    auto const v = p;
+    p = sum;
+    sum += v;
+  }
+
+  pool.parallel_for(runs, [&](std::size_t const &r) {
+    auto s = part[r];
+    for (auto i = n * r / runs; i < n * (r + 1) / runs; i++) {
+      auto const v = a[i];
+      a[i] = s;
+      s += v;
+    }
+  });
+
+  return sum;
+}
+
+//! Encode n symbols as a block on its own, its stored table followed by its
+//! rANS bytes, into out, which must hold table_size + rans<dataT>::bound(n)
+//! bytes, and return the number of bytes written.
+template <class dataT>
+inline auto encode_block(byte const *in, std::size_t const &n, int const &bits, byte *out) -> std::size_t {
+  using codec = rans<dataT>;
+
+  internal::vector<freq> f(codec::alphabet);
+  histogram<dataT>(in, n, f);
+  normalize(f, bits);
+
+  codec const c(f, bits);
+  return table_size + c.encode(in, n, put_table(f, out));
+}
+
+//! Decode a block of n symbols written by encode_block() from the size bytes
+//! at in. Returns false if the block is found to be truncated or corrupt.
+template <class dataT>
+inline auto decode_block(byte const *in, std::size_t const &size, std::size_t const &n,
+                         int const &bits, byte *out) -> bool {
+  using codec = rans<dataT>;
+
+  if (size < table_size)
+    return false;
+
+  internal::vector<freq> f(codec::alphabet);
+  auto const *const p = get_table(in, f);
+
+  // a table that does not sum to 2^bits would overrun the decoder's lookup.
+  std::size_t sum = 0;
+  for (auto const &v : f)
+    sum += v;
+  if (sum != static_cast<std::size_t>(1) << bits)
+    return false;
+
+  codec const c(f, bits);
+  return c.decode(p, size - table_size, n, out);
+}
+
+//! Block-parallel rANS coder for byte symbols over a thread pool.
+template <class dataT>
+class parallel_rans {
+  private:
+    using codec = rans<dataT>;
+
+  public:
+    //! default block size, in symbols
+    static constexpr std::size_t default_block = static_cast<std::size_t>(1) << 20;
+    //! largest block size, which keeps every block size within 32 bits
+    static constexpr std::size_t max_block = static_cast<std::size_t>(1) << 30;
+    //! default precision of the frequency tables, supported by every type
+    static constexpr int default_bits = 12;
+    //! supported range of the frequency table precision; a stored table
+    //! entry is 16 bits wide
+    static constexpr int min_bits = codec::min_bits;
+    static constexpr int max_bits = codec::max_bits < 15 ? codec::max_bits : 15;
+    //! bytes ahead of the block sizes
+    static constexpr std::size_t header_size = 8 + 4 + 1;
+
+  private:
+    thread_pool *pool_;
+    std::size_t  block_;
+    int          bits_;
+
+    static auto blocks(std::size_t const &n, std::size_t const &block) -> std::size_t {
+      return n / block + (0 != n % block);
+    }
+
+  public:
+    // Ctors
+    //! block in [1, max_block] and bits in [min_bits, max_bits]; the pool must
+    //! outlive the coder. Throws std::invalid_argument if either is out of
+    //! range.
+    explicit parallel_rans(thread_pool &pool, std::size_t const &block = default_block,
+                           int const &bits = default_bits);
+
+    //! Upper bound on the encoded size of n symbols.
+    auto bound(std::size_t const &n) const -> std::size_t {
+      auto const nb = blocks(n, block_);
+      auto const r  = n - (nb ? nb - 1 : 0) * block_;
+      return header_size + nb * (4 + table_size)
+           + (nb ? (nb - 1) * codec::bound(block_) + codec::bound(r) : 0);
+    }
+
+    //! Number of symbols in the output of encode(), of which at least
+    //! header_size bytes are at in.
+    static auto size(byte const *in) -> std::size_t {
+      std::uint64_t n;
+      std::memcpy(&n, in, sizeof(n));
+      return static_cast<std::size_t>(n);
+    }
+
+    //! Encode n symbols into out, which must hold bound(n) bytes, and return
+    //! the number of bytes written.
+    auto encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t;
+    //! Decode the size bytes of output of encode() at in into out, which must
+    //! hold size(in) symbols. The block size and precision are taken from in.
+    //! Returns false if in is found to be truncated or corrupt, in which case
+    //! out holds garbage; no byte outside in is read either way.
+    auto decode(byte const *in, std::size_t const &size, byte *out) const -> bool;
+};
+
+template <class dataT>
+inline parallel_rans<dataT>::parallel_rans(thread_pool &pool, std::size_t const &block, int const &bits)
+  : pool_(&pool), block_(block), bits_(bits)
+{
+  if (0 == block || block > max_block)
+    throw std::invalid_argument("parallel_rans: block out of range");
+  if (bits < min_bits || bits > max_bits)
+    throw std::invalid_argument("parallel_rans: bits out of range");
+}
+
+template <class dataT>
+inline auto parallel_rans<dataT>::encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t {
+  auto const nb   = blocks(n, block_);
+  auto const slot = table_size + codec::bound(block_);
+
+  internal::vector<byte>        tmp(nb * slot);
+  internal::vector<std::size_t> len(nb);
+
+  pool_->parallel_for(nb, [&](std::size_t const &b) {
+    auto const at = b * block_;
+    auto const m  = at + block_ < n ? block_ : n - at;
+    len[b] = encode_block<dataT>(in + at, m, bits_, tmp.data() + b * slot);
+  });
+
+  std::uint64_t const n64 = n;
+  std::uint32_t const b32 = static_cast<std::uint32_t>(block_);
+  std::uint8_t  const bits = static_cast<std::uint8_t>(bits_);
+  std::memcpy(out, &n64, sizeof(n64));
+  std::memcpy(out + 8, &b32, sizeof(b32));
+  std::memcpy(out + 12, &bits, sizeof(bits));
+
+  auto *const dir = out + header_size;
+  for (std::size_t b = 0; b < nb; b++) {
+    auto const l = static_cast<std::uint32_t>(len[b]);
+    std::memcpy(dir + 4 * b, &l, sizeof(l));
+  }
+
+  // len becomes the offset of every block; the sizes stay in the directory.
+  auto *const body  = dir + 4 * nb;
+  auto const  total = exclusive_scan(*pool_, len.data(), nb);
+
+  pool_->parallel_for(nb, [&](std::size_t const &b) {
+    auto const end = b + 1 < nb ? len[b + 1] : total;
+    std::memcpy(body + len[b], tmp.data() + b * slot, end - len[b]);
+  });
+
+  return header_size + 4 * nb + total;
+}
+
+template <class dataT>
+inline auto parallel_rans<dataT>::decode(byte const *in, std::size_t const &size,
+                                         byte *out) const -> bool {
+  if (size < header_size)
+    return false;
+
+  std::uint32_t b32;
+  std::uint8_t  bits;
+  std::memcpy(&b32, in + 8, sizeof(b32));
+  std::memcpy(&bits, in + 12, sizeof(bits));
+
+  if (0 == b32 || b32 > max_block || bits < min_bits || bits > max_bits)
+    return false;
+
+  auto const n     = parallel_rans::size(in);
+  auto const block = static_cast<std::size_t>(b32);
+  auto const nb    = blocks(n, block);
+
+  // the directory and the blocks it sizes must all lie within in.
+  auto const avail = size - header_size;
+  if (nb > avail / 4)
+    return false;
+
+  auto const *const dir = in + header_size;
+  internal::vector<std::size_t> off(nb);
+  auto left = avail - 4 * nb;
+  for (std::size_t b = 0; b < nb; b++) {
+    std::uint32_t l;
+    std::memcpy(&l, dir + 4 * b, sizeof(l));
+    if (l > left)
+      return false;
+    off[b] = l;
+    left  -= l;
+  }
+
+  auto const *const body  = dir + 4 * nb;
+  auto const        total = exclusive_scan(*pool_, off.data(), nb);
+
+  std::atomic<bool> ok(true);
+  pool_->parallel_for(nb, [&](std::size_t const &b) {
+    auto const at  = b * block;
+    auto const m   = at + block < n ? block : n - at;
+    auto const end = b + 1 < nb ? off[b + 1] : total;
+    if (!decode_block<dataT>(body + off[b], end - off[b], m, bits, out + at))
+      ok.store(false, std::memory_order_relaxed);
+  });
+
+  return ok.load(std::memory_order_relaxed);
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_PARALLEL_H
@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_PIPELINE_H
+#define COMP_CORE_PIPELINE_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "container.h"
+#include "io.h"
+#include "parallel.h"
+#include "rans.h"
+#include "thread_pool.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// streaming compression.
+//
+// A file is read, coded and written as a container a block at a time, with
+// the three overlapped. Every block goes through one slot of a fixed ring: it
+// is read into the slot, coded on the pool together with every other block
+// whose read is done, written out, and its slot handed to the next block to
+// be read. Reads and writes are in flight through an i/o queue while the pool
+// codes, and a block that finds no free slot is not read until one frees up,
+// so the memory in use is fixed by the depth of the ring, whatever the size
+// of the file, and the slower of the disk and the coder sets the pace.
+//
+// Blocks are coded in file order, which is what gives every block its place
+// in the output as soon as it is coded; only the index, written last, grows
+// with the file. Whatever way compression ends, nothing is left in flight
+// into the buffers: should the queue fail, what it has not started is taken
+// back and the rest is waited out.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Compresses files into containers, overlapping i/o with coding.
+template <class dataT>
+class pipeline {
+  private:
+    using codec  = rans<dataT>;
+    using format = container_format;
+
+    //! where a slot is
+    enum : unsigned char { idle, reading, ready, writing };
+
+    //! one read or write, with what of it is done
+    struct op {
+      byte         *p;
+      std::size_t   len;
+      std::size_t   done;
+      std::uint64_t at;
+    };
+
+    thread_pool *pool_;
+    std::size_t  block_;
+    int          bits_;
+    std::size_t  depth_;
+
+  public:
+    static constexpr std::size_t default_block = container_writer<dataT>::default_block;
+    static constexpr int         default_bits  = container_writer<dataT>::default_bits;
+
+    // Ctors
+    //! block and bits as for container_writer, and a ring of depth slots, or
+    //! four per thread of the pool if depth is 0; the pool must outlive the
+    //! pipeline. Throws std::invalid_argument if block or bits is out of
+    //! range, before any file is touched.
+    explicit pipeline(thread_pool &pool, std::size_t const &block = default_block,
+                      int const &bits = default_bits, std::size_t const &depth = 0)
+      : pool_(&pool), block_(block), bits_(bits), depth_(depth ? depth : 4 * (pool.size() + 1))
+    {
+      if (0 == block || block > container_writer<dataT>::max_block)
+        throw std::invalid_argument("pipeline: block out of range");
+      if (bits < container_writer<dataT>::min_bits || bits > container_writer<dataT>::max_bits)
+        throw std::invalid_argument("pipeline: bits out of range");
+    }
+
+    //! Bytes of the ring, which bound the buffers in use apart from the index.
+    auto memory() const -> std::size_t { return depth_ * (block_ + table_size + codec::bound(block_)); }
+
+    //! Write the container of the regular file open at in to the file open at
+    //! out, from its start, through io_uring where the kernel supports it and
+    //! through blocking calls otherwise, and cut a regular out down to the
+    //! container. Returns false on any i/o error.
+    auto compress(int const &in, int const &out) const -> bool;
+    //! As compress(), with the file at src into the file at dst, which is
+    //! created or truncated.
+    auto compress(char const *src, char const *dst) const -> bool;
+    //! As compress(), through the i/o queue io.
+    template <class ioT>
+    auto compress(ioT &io, int const &in, int const &out) const -> bool;
+};
+
+template <class dataT>
+inline auto pipeline<dataT>::compress(int const &in, int const &out) const -> bool {
+#if defined(COMP_CORE_IO_URING)
+  // a slot is reading or writing, never both, and the header and index are
+  // written once each.
+  uring_queue u(static_cast<unsigned>(depth_ + 2));
+  if (u.ok() && u.size() >= depth_ + 2)
+    return compress(u, in, out);
+#endif
+  blocking_queue b;
+  return compress(b, in, out);
+}
+
+template <class dataT>
+inline auto pipeline<dataT>::compress(char const *src, char const *dst) const -> bool {
+  auto const in = ::open(src, O_RDONLY);
+  if (in < 0)
+    return false;
+  auto const out = ::open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  auto ok = out >= 0 && compress(in, out);
+  if (out >= 0)
+    ok = 0 == ::close(out) && ok;
+  ::close(in);
+  return ok;
+}
+
+template <class dataT>
+template <class ioT>
+inline auto pipeline<dataT>::compress(ioT &io, int const &in, int const &out) const -> bool {
+  struct stat st;
+  if (0 != ::fstat(in, &st) || !S_ISREG(st.st_mode))
+    return false;
+
+  container_writer<dataT> const w(*pool_, block_, bits_);
+
+  auto const n    = static_cast<std::size_t>(st.st_size);
+  auto const nb   = (n + block_ - 1) / block_;
+  auto const ring = nb < depth_ ? (nb ? nb : 1) : depth_;
+  auto const slot = table_size + codec::bound(block_);
+
+  internal::vector<byte>          ibuf(ring * block_);
+  internal::vector<byte>          obuf(ring * slot);
+  internal::vector<unsigned char> state(ring, idle);
+  internal::vector<std::uint64_t> off(nb);
+
+  // ops[0..ring) are the slots, then the header and the index.
+  internal::vector<op> ops(ring + 2);
+  auto const head  = ring;
+  auto const index = ring + 1;
+
+  std::size_t inflight = 0;
+  bool        failed   = false;
+  bool        broken   = false;
+
+  auto const issue = [&](std::size_t const &t, bool const &write) {
+    auto const &o = ops[t];
+    if (write)
+      io.write(out, o.p + o.done, o.len - o.done, o.at + o.done, t);
+    else
+      io.read(in, o.p + o.done, o.len - o.done, o.at + o.done, t);
+    inflight++;
+  };
+
+  std::size_t written = 0;
+  auto const complete = [&](io_completion const &c) {
+    inflight--;
+    if (failed)
+      return;
+    // a read that comes up short at the end means the file shrank under us.
+    if (c.res <= 0) {
+      failed = true;
+      return;
+    }
+
+    auto const t = static_cast<std::size_t>(c.tag);
+    auto &o = ops[t];
+    o.done += static_cast<std::size_t>(c.res);
+    if (o.done < o.len) {
+      issue(t, t >= ring || writing == state[t]);
+    } else if (t >= ring) {
+      // the header or the index
+    } else if (reading == state[t]) {
+      state[t] = ready;
+    } else {
+      state[t] = idle;
+      written++;
+    }
+  };
+
+  byte header[format::header_size];
+  w.put_header(header);
+  ops[head] = { header, format::header_size, 0, 0 };
+  issue(head, true);
+
+  std::size_t next_read = 0, next_code = 0;
+  std::uint64_t pos = format::header_size;
+  while (!failed && written < nb) {
+    // a read into every free slot, in file order.
+    for (; next_read < nb && idle == state[next_read % ring]; next_read++) {
+      auto const k  = next_read % ring;
+      auto const at = next_read * block_;
+      ops[k]   = { ibuf.data() + k * block_, at + block_ < n ? block_ : n - at, 0, at };
+      state[k] = reading;
+      issue(k, false);
+    }
+    if (!io.submit()) {
+      broken = true;
+      break;
+    }
+
+    // code the blocks read so far that come next in the file, while the
+    // reads and writes in flight go on, then write them out.
+    auto const first = next_code;
+    while (next_code < next_read && ready == state[next_code % ring])
+      next_code++;
+
+    if (first < next_code) {
+      pool_->parallel_for(next_code - first, [&](std::size_t const &i) {
+        auto const k = (first + i) % ring;
+        ops[k].len = encode_block<dataT>(ibuf.data() + k * block_, ops[k].len, bits_, obuf.data() + k * slot);
+      });
+
+      for (auto b = first; b < next_code; b++) {
+        auto const k = b % ring;
+        off[b]   = pos;
+        ops[k]   = { obuf.data() + k * slot, ops[k].len, 0, pos };
+        pos     += ops[k].len;
+        state[k] = writing;
+        issue(k, true);
+      }
+      if (!io.submit()) {
+        broken = true;
+        break;
+      }
+    } else {
+      io_completion c;
+      if (!io.wait(c)) {
+        broken = true;
+        break;
+      }
+      complete(c);
+    }
+
+    for (io_completion c; io.poll(c);)
+      complete(c);
+  }
+
+  internal::vector<byte> tail;
+  if (!broken && !failed && written == nb) {
+    tail.resize(nb * format::entry_size + format::trailer_size);
+    w.put_index(off.data(), n, static_cast<std::size_t>(pos), tail.data());
+    ops[index] = { tail.data(), tail.size(), 0, pos };
+    issue(index, true);
+  } else {
+    failed = true;
+  }
+
+  // nothing in flight may outlive the buffers. Once the queue has failed,
+  // what it never started is taken back, and what it did still completes, so
+  // it is polled for until it has.
+  while (0 != inflight) {
+    io_completion c;
+    if (!broken && io.submit() && io.wait(c)) {
+      complete(c);
+    } else if (!broken) {
+      broken = failed = true;
+      inflight -= io.cancel();
+    } else if (io.poll(c)) {
+      complete(c);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  if (failed)
+    return false;
+
+  // out may have held more than the container.
+  auto const size = static_cast<off_t>(pos + tail.size());
+  return 0 == ::fstat(out, &st) && (!S_ISREG(st.st_mode) || 0 == ::ftruncate(out, size));
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_PIPELINE_H
@@ -0,0 +1,305 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_RANS_H
+#define COMP_CORE_RANS_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+#include "algorithm.h"
+#include "divisor.h"
+#include "lookup.h"
+#include "stream.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// interleaved range asymmetric numeral systems.
+//
+// Each lane of a data type carries its own 32-bit coder state x in [L, 256L),
+// L = 2^23, and codes every arity'th symbol of the input. With a frequency
+// table normalized to M = 2^bits, a symbol s of frequency f and cumulative
+// frequency c is encoded as
+//
+//   x' = (x / f) * M + (x % f) + c
+//
+// after shifting the low bytes of x out until x < f * 2^(31 - bits), and is
+// decoded from the slot x' % M as
+//
+//   x = f * (x' / M) + (x' % M) - c
+//
+// before shifting bytes back in until x >= L. The bytes of all lanes are
+// interleaved with masked stores and loads, so the streams are shared and no
+// per-lane bookkeeping is needed. The encoder runs back to front, which lets
+// the decoder consume its output front to back.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Scale the symbol counts in f so that they sum to 2^bits, keeping every
+//! symbol that occurs at least once codeable.
+template < template <class, class> class contT
+         , class alocT >
+inline auto normalize(contT<freq, alocT> &f, int const &bits) -> void {
+  freq const m = static_cast<freq>(1) << bits;
+
+  freq total = 0;
+  for (auto const &c : f)
+    total += c;
+  if (0 == total)
+    return;
+
+  freq sum = 0;
+  std::size_t top = 0;
+  for (std::size_t i = 0; i < f.size(); i++) {
+    if (f[i]) {
+      auto const c = f[i];
+      f[i] = static_cast<freq>((static_cast<unsigned __int128>(c) * m) / total);
+      if (0 == f[i])
+        f[i] = 1;
+      if (f[i] > f[top])
+        top = i;
+    }
+    sum += f[i];
+  }
+
+  // rounding error is at most one per symbol, so it usually fits in the most
+  // frequent one; otherwise take it from whichever symbol is largest.
+  if (sum <= m || f[top] > sum - m) {
+    f[top] = f[top] + m - sum;
+    return;
+  }
+  while (sum > m) {
+    for (std::size_t i = 0; i < f.size(); i++)
+      if (f[i] > f[top])
+        top = i;
+    f[top]--;
+    sum--;
+  }
+}
+
+//! bytes of a stored frequency table
+static constexpr std::size_t table_size = 2 * 256;
+
+//! Store the first 256 frequencies of f, normalized to 2^bits with bits < 16,
+//! as 16-bit words, and return the end of the table.
+template < template <class, class> class contT
+         , class alocT >
+inline auto put_table(contT<freq, alocT> const &f, byte *out) -> byte* {
+  for (std::size_t s = 0; s < 256; s++) {
+    auto const w = static_cast<std::uint16_t>(s < f.size() ? f[s] : 0);
+    std::memcpy(out + 2 * s, &w, sizeof(w));
+  }
+  return out + table_size;
+}
+
+//! Load a table stored by put_table() into the first 256 entries of f, and
+//! return the end of the table.
+template < template <class, class> class contT
+         , class alocT >
+inline auto get_table(byte const *in, contT<freq, alocT> &f) -> byte const* {
+  for (std::size_t s = 0; s < 256; s++) {
+    std::uint16_t w;
+    std::memcpy(&w, in + 2 * s, sizeof(w));
+    f[s] = w;
+  }
+  return in + table_size;
+}
+
+//! Interleaved rANS coder for byte symbols, one coder state per lane of dataT.
+template <class dataT>
+class rans {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using unitT = typename data_traits<dataT>::unit_type;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    static constexpr auto half  = data_traits<dataT>::unit_width / 2;
+
+  public:
+    //! number of distinct symbols
+    static constexpr std::size_t alphabet = 256;
+    //! lower bound of a coder state
+    static constexpr unitT lower = static_cast<unitT>(1) << 23;
+    //! supported range of the frequency table precision
+    static constexpr int min_bits = 8;
+    static constexpr int max_bits = lookup<dataT>::max_bits;
+
+  private:
+    int bits_;
+    //! (M - f) in the upper half of the unit, c in the lower half
+    internal::vector<unitT> sym_;
+    //! reciprocal of f
+    internal::vector<reciprocal<unitT>> rcp_;
+    //! symbol, f and c owning each of the M slots
+    lookup<dataT> dec_;
+
+    //! bits, checked before any table is built from it
+    static auto checked(int const &bits) -> int {
+      if (bits < min_bits || bits > max_bits)
+        throw std::invalid_argument("rans: bits out of range");
+      return bits;
+    }
+
+    auto encode_step(baseT const &x, baseT const &s, reverse_stream<dataT> &os) const -> baseT;
+    auto decode_step(baseT const &x, byte *out, bounded_stream<dataT> &is) const -> baseT;
+
+  public:
+    // Ctors
+    //! f must hold alphabet frequencies summing to 2^bits, with bits in
+    //! [min_bits, max_bits], see normalize(). Throws std::invalid_argument if
+    //! bits is out of range.
+    template < template <class, class> class contT
+             , class alocT >
+    rans(contT<freq, alocT> const &f, int const &bits);
+
+    //! Upper bound on the encoded size of n symbols.
+    static auto bound(std::size_t const &n) -> std::size_t {
+      // at most two bytes per symbol, padding included, the flushed states and
+      // the slack of the stream.
+      return 2 * (n + arity) + 4 * arity + arity;
+    }
+
+    //! Encode n symbols into out, which must hold bound(n) bytes, and return
+    //! the number of bytes written.
+    auto encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t;
+    //! Decode n symbols from the size bytes at in, which must be the output of
+    //! encode(). Returns false if in is found to be truncated or corrupt, in
+    //! which case out holds garbage; no byte outside in is read either way.
+    auto decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool;
+};
+
+template <class dataT>
+template < template <class, class> class contT
+         , class alocT >
+inline rans<dataT>::rans(contT<freq, alocT> const &f, int const &bits)
+  : bits_(checked(bits)), sym_(alphabet), rcp_(alphabet), dec_(f, bits)
+{
+  unitT const m = static_cast<unitT>(1) << bits;
+
+  unitT c = 0;
+  for (std::size_t s = 0; s < alphabet && s < f.size(); s++) {
+    auto const fs = static_cast<unitT>(f[s]);
+    if (0 == fs)
+      continue;
+
+    sym_[s] = ((m - fs) << half) | c;
+    rcp_[s] = reciprocal<unitT>(fs);
+    c += fs;
+  }
+}
+
+template <class dataT>
+inline auto rans<dataT>::encode_step(baseT const &x, baseT const &s, reverse_stream<dataT> &os) const -> baseT {
+  auto const m  = static_cast<unitT>(1) << bits_;
+  auto const e  = static_cast<baseT>(gather(sym_, dataT(s)));
+  auto const g  = abi::bsr(e, half);
+  auto const c  = abi::land(e, abi::set((static_cast<unitT>(1) << half) - 1));
+  auto const xm = abi::bsl(abi::sub(abi::set(m), g), 31 - bits_);
+
+  // shift out the low bytes of every lane that would overflow.
+  auto y = x;
+  for (maskT k; (k = abi::cmple(xm, y));) {
+    os.masked_write(dataT(y), k);
+    y = abi::mbsr(k, y, 8);
+  }
+
+  // (y / f) * M + (y % f) + c == y + (y / f) * (M - f) + c, where y / f
+  // fits in 32 bits and M - f in 16, so the product is narrow.
+  auto const q = static_cast<baseT>(dataT(y) / gather(rcp_, dataT(s)));
+  return abi::muladd52(q, g, abi::add(y, c));
+}
+
+template <class dataT>
+inline auto rans<dataT>::decode_step(baseT const &x, byte *out, bounded_stream<dataT> &is) const -> baseT {
+  auto const m    = static_cast<unitT>(1) << bits_;
+  auto const slot = abi::land(x, abi::set(m - 1));
+  auto const e    = dec_(dataT(slot));
+
+  abi::put(out, static_cast<baseT>(e.sym));
+  auto y = abi::muladd52(static_cast<baseT>(e.frq), abi::bsr(x, bits_),
+                         abi::sub(slot, static_cast<baseT>(e.cum)));
+
+  // the encoder wrote the lowest byte of a lane last, so count the bytes each
+  // lane needs before reading the groups back in reverse.
+  maskT k[4];
+  int t = 0;
+  for (auto z = y; t < 4 && (k[t] = abi::cmpgt(abi::set(lower), z)); t++)
+    z = abi::mbsl(k[t], z, 8);
+  while (t--) {
+    dataT b(abi::set(0));
+    is.masked_read(b, k[t]);
+    y = abi::lor(abi::mbsl(k[t], y, 8), static_cast<baseT>(b));
+  }
+
+  return y;
+}
+
+template <class dataT>
+inline auto rans<dataT>::encode(byte const *in, std::size_t const &n, byte *out) const -> std::size_t {
+  auto const nv = n / arity;
+  auto const r  = n % arity;
+
+  reverse_stream<dataT> os(out, bound(n));
+
+  auto x = abi::set(lower);
+
+  // pad the partial vector with a symbol that is known to be codeable.
+  if (r) {
+    byte tail[arity];
+    std::memset(tail, in[n - 1], arity);
+    std::memcpy(tail, in + nv * arity, r);
+    x = encode_step(x, abi::get(tail), os);
+  }
+  for (auto i = nv; i-- > 0;)
+    x = encode_step(x, abi::get(in + i * arity), os);
+
+  // flush the full states, lowest byte last.
+  for (int i = 0; i < 4; i++) {
+    os.write(dataT(x));
+    x = abi::bsr(x, 8);
+  }
+
+  auto const size = static_cast<std::size_t>(out + bound(n) - os.pos());
+  std::memmove(out, os.pos(), size);
+  return size;
+}
+
+template <class dataT>
+inline auto rans<dataT>::decode(byte const *in, std::size_t const &size, std::size_t const &n, byte *out) const -> bool {
+  auto const nv = n / arity;
+  auto const r  = n % arity;
+
+  bounded_stream<dataT> is(in, size);
+
+  auto x = abi::set(0);
+  for (int i = 0; i < 4; i++) {
+    dataT b(abi::set(0));
+    is.read(b);
+    x = abi::lor(abi::bsl(x, 8), static_cast<baseT>(b));
+  }
+
+  for (std::size_t i = 0; i < nv; i++)
+    x = decode_step(x, out + i * arity, is);
+
+  if (r) {
+    byte tail[arity];
+    x = decode_step(x, tail, is);
+    std::memcpy(out + nv * arity, tail, r);
+  }
+
+  // every lane ends where the encoder started it, unless in is corrupt.
+  return is.ok() && abi::mask_max == abi::cmpeq(x, abi::set(lower));
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_RANS_H
@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_STREAM_H
+#define COMP_CORE_STREAM_H 1
+
+#include <cstddef>
+#include <cstring>
+
+#include "core/internal/isa.h"
+#include "traits.h"
+#include "types.h"
+
+//------------------------------------------------------------------------------
+// masked byte streams over caller-owned memory.
+//
+// A masked access moves one byte per active lane, packed in lane order, and
+// advances the stream by mcnt(k). A forward stream moves from the start of
+// its buffer towards the end; a reverse stream moves from the end towards the
+// start, placing each group before the previous one, so reading the buffer
+// forward afterwards yields the groups last written first, as rANS needs.
+//
+// The last bytes a stream would reach are slack. No access can leave the
+// buffer, since one moves at most arity bytes and the position is clamped to
+// the slack, so the fast path has no branch. Reaching the slack exhausts the
+// stream: ok() turns false and everything from then on is unspecified, so
+// callers test ok() once when they are done.
+//
+// A masked read may load abi::mget_span bytes, more than it moves, so the
+// slack of a forward stream is the wider of the two. A reverse stream that is
+// read needs abi::mget_span bytes readable past its end.
+//
+// Input read back from a caller, whose end need not be followed by slack, is
+// read through a bounded stream instead, which holds the slack itself.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+//! Stream over [p, p + n), from p upwards, with n no less than arity and
+//! abi::mget_span. byteT is const for a read-only stream.
+template <class dataT, class byteT = byte>
+class stream {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    //! bytes of slack, the widest access
+    static constexpr std::size_t span = arity > abi::mget_span ? arity : abi::mget_span;
+
+    byteT *ptr_;
+    //! start of the slack
+    byteT *end_;
+
+  public:
+    // Ctors
+    //! The n bytes at p must outlive the stream.
+    stream(byteT *p, std::size_t const &n) : ptr_(p), end_(p + n - span) { }
+
+    //! Read the next mcnt(k) bytes into the active lanes of a, zeroing the
+    //! others.
+    auto masked_read(dataT &a, maskT const &k) -> void;
+    //! Write the active lanes of a, one byte each.
+    auto masked_write(dataT const &a, maskT const &k) -> void;
+
+    //! Read the next arity bytes, one per lane.
+    auto read(dataT &a) -> void;
+    //! Write the low byte of every lane.
+    auto write(dataT const &a) -> void;
+
+    //! false once the stream has reached its slack.
+    auto ok() const -> bool { return ptr_ < end_; }
+    //! the next byte to be accessed
+    auto pos() const -> byteT* { return ptr_; }
+};
+
+//! Stream over [p, p + n), from p + n downwards, with n >= arity. byteT is
+//! const for a read-only stream.
+template <class dataT, class byteT = byte>
+class reverse_stream {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using baseT = typename data_traits<dataT>::base_type;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+
+    byteT *ptr_;
+    //! end of the slack
+    byteT *begin_;
+
+  public:
+    // Ctors
+    //! The n bytes at p must outlive the stream.
+    reverse_stream(byteT *p, std::size_t const &n) : ptr_(p + n), begin_(p + arity) { }
+
+    //! Read the mcnt(k) bytes before the current position into the active
+    //! lanes of a, zeroing the others.
+    auto masked_read(dataT &a, maskT const &k) -> void;
+    //! Write the active lanes of a, one byte each, before the current
+    //! position.
+    auto masked_write(dataT const &a, maskT const &k) -> void;
+
+    //! Read the arity bytes before the current position, one per lane.
+    auto read(dataT &a) -> void;
+    //! Write the low byte of every lane before the current position.
+    auto write(dataT const &a) -> void;
+
+    //! false once the stream has reached its slack.
+    auto ok() const -> bool { return ptr_ > begin_; }
+    //! the last byte accessed, i.e., the start of the bytes written so far
+    auto pos() const -> byteT* { return ptr_; }
+};
+
+//! Read-only stream over exactly [p, p + n), from p upwards. It reads the
+//! input in place until an access could leave it, then a copy of what is left
+//! followed by slack of its own; the test for that is the one branch of an
+//! access, and is taken once.
+template <class dataT>
+class bounded_stream {
+  private:
+    using abi   = typename data_traits<dataT>::abi;
+    using maskT = typename data_traits<dataT>::mask_type;
+
+    static constexpr auto arity = data_traits<dataT>::arity;
+    //! widest access, which may load more than it moves
+    static constexpr std::size_t span = arity > abi::mget_span ? arity : abi::mget_span;
+
+    byte const *ptr_;
+    //! last position an access may start from
+    byte const *end_;
+    //! end of the input, or of what is left of it in tail_
+    byte const *stop_;
+    //! the last bytes of the input, then zeros
+    byte        tail_[2 * span];
+
+    auto spill() -> void;
+
+  public:
+    // Ctors
+    //! The n bytes at p must outlive the stream.
+    bounded_stream(byte const *p, std::size_t const &n) : ptr_(p), end_(p), stop_(p + n) {
+      if (n >= span)
+        end_ = p + n - span;
+      else
+        spill();
+    }
+    bounded_stream(bounded_stream const &) = delete;
+    auto operator=(bounded_stream const &) -> bounded_stream& = delete;
+
+    //! Read the next mcnt(k) bytes into the active lanes of a, zeroing the
+    //! others.
+    auto masked_read(dataT &a, maskT const &k) -> void;
+    //! Read the next arity bytes, one per lane.
+    auto read(dataT &a) -> void;
+
+    //! false once more bytes have been read than the input holds.
+    auto ok() const -> bool { return ptr_ <= stop_; }
+};
+
+//==============================================================================
+// stream
+//==============================================================================
+template <class dataT, class byteT>
+inline auto stream<dataT, byteT>::masked_read(dataT &a, maskT const &k) -> void {
+  a = dataT(abi::mget(k, ptr_));
+  auto const q = ptr_ + abi::mcnt(k);
+  ptr_ = q < end_ ? q : end_;
+}
+
+template <class dataT, class byteT>
+inline auto stream<dataT, byteT>::masked_write(dataT const &a, maskT const &k) -> void {
+  abi::mput(ptr_, k, static_cast<baseT>(a));
+  auto const q = ptr_ + abi::mcnt(k);
+  ptr_ = q < end_ ? q : end_;
+}
+
+template <class dataT, class byteT>
+inline auto stream<dataT, byteT>::read(dataT &a) -> void {
+  a = dataT(abi::get(ptr_));
+  auto const q = ptr_ + arity;
+  ptr_ = q < end_ ? q : end_;
+}
+
+template <class dataT, class byteT>
+inline auto stream<dataT, byteT>::write(dataT const &a) -> void {
+  abi::put(ptr_, static_cast<baseT>(a));
+  auto const q = ptr_ + arity;
+  ptr_ = q < end_ ? q : end_;
+}
+
+//==============================================================================
+// reverse_stream
+//==============================================================================
+template <class dataT, class byteT>
+inline auto reverse_stream<dataT, byteT>::masked_read(dataT &a, maskT const &k) -> void {
+  auto const q = ptr_ - abi::mcnt(k);
+  a = dataT(abi::mget(k, q));
+  ptr_ = q > begin_ ? q : begin_;
+}
+
+template <class dataT, class byteT>
+inline auto reverse_stream<dataT, byteT>::masked_write(dataT const &a, maskT const &k) -> void {
+  auto const q = ptr_ - abi::mcnt(k);
+  abi::mput(q, k, static_cast<baseT>(a));
+  ptr_ = q > begin_ ? q : begin_;
+}
+
+template <class dataT, class byteT>
+inline auto reverse_stream<dataT, byteT>::read(dataT &a) -> void {
+  auto const q = ptr_ - arity;
+  a = dataT(abi::get(q));
+  ptr_ = q > begin_ ? q : begin_;
+}
+
+template <class dataT, class byteT>
+inline auto reverse_stream<dataT, byteT>::write(dataT const &a) -> void {
+  auto const q = ptr_ - arity;
+  abi::put(q, static_cast<baseT>(a));
+  ptr_ = q > begin_ ? q : begin_;
+}
+
+//==============================================================================
+// bounded_stream
+//==============================================================================
+template <class dataT>
+inline auto bounded_stream<dataT>::spill() -> void {
+  // past the end of tail_ the input is overrun, so keep to its zeros.
+  if (end_ == tail_ + span) {
+    ptr_ = end_;
+    return;
+  }
+
+  auto const r = static_cast<std::size_t>(stop_ - ptr_);
+  std::memset(tail_, 0, sizeof(tail_));
+  if (r)
+    std::memcpy(tail_, ptr_, r);
+
+  ptr_  = tail_;
+  end_  = tail_ + span;
+  stop_ = tail_ + r;
+}
+
+template <class dataT>
+inline auto bounded_stream<dataT>::masked_read(dataT &a, maskT const &k) -> void {
+  if (ptr_ > end_)
+    spill();
+  a = dataT(abi::mget(k, ptr_));
+  ptr_ += abi::mcnt(k);
+}
+
+template <class dataT>
+inline auto bounded_stream<dataT>::read(dataT &a) -> void {
+  if (ptr_ > end_)
+    spill();
+  a = dataT(abi::get(ptr_));
+  ptr_ += arity;
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_STREAM_H
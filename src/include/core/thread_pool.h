@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: MIT
+#ifndef COMP_CORE_THREAD_POOL_H
+#define COMP_CORE_THREAD_POOL_H 1
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "core/internal/isa.h"
+#include "core/internal/vector.h"
+
+//------------------------------------------------------------------------------
+// work-stealing thread pool.
+//
+// Every worker owns a deque of tasks. parallel_for() deals its indices out in
+// contiguous runs, one run per deque, so a worker walks its run from the front
+// in memory order, while a worker that has run dry steals from the back of
+// the others. The calling thread works through the tasks as well until they
+// are all done, so a task may itself call parallel_for() on the same pool.
+//
+// Like internal::vector, the pool lives in the instruction set namespace, so
+// kernels built for different instruction sets each get their own copy.
+//------------------------------------------------------------------------------
+namespace comp {
+namespace core {
+inline namespace COMP_CORE_ISA_NAMESPACE {
+
+class thread_pool {
+  private:
+    //! one parallel_for() call
+    struct job {
+      void (*run)(void const *fn, std::size_t const &i);
+      void const              *fn;
+      std::atomic<std::size_t> left;
+      std::mutex               m;
+      std::condition_variable  cv;
+    };
+
+    struct task {
+      job        *j;
+      std::size_t i;
+    };
+
+    struct queue {
+      std::mutex                                  m;
+      std::deque<task, internal::allocator<task>> q;
+    };
+
+    internal::vector<std::unique_ptr<queue>> queues_;
+    internal::vector<std::thread>            threads_;
+
+    //! tasks queued and not yet taken, guarded by m_ for sleeping
+    std::atomic<std::size_t> queued_;
+    std::mutex               m_;
+    std::condition_variable  cv_;
+    bool                     stop_;
+
+    auto take(std::size_t const &self, task &t) -> bool;
+    auto finish(task const &t) -> void;
+    auto work(std::size_t const &self) -> void;
+
+  public:
+    // Ctors
+    //! Start n workers, or one per hardware thread if n is 0.
+    explicit thread_pool(unsigned int const &n = 0);
+    thread_pool(thread_pool const &) = delete;
+    auto operator=(thread_pool const &) -> thread_pool& = delete;
+
+    // Dtor
+    ~thread_pool();
+
+    //! number of workers
+    auto size() const -> std::size_t { return threads_.size(); }
+
+    //! Call f(i) for every i in [0, n) and return once all calls have.
+    template <class fnT>
+    auto parallel_for(std::size_t const &n, fnT const &f) -> void;
+};
+
+inline thread_pool::thread_pool(unsigned int const &n) : queued_(0), stop_(false) {
+  auto const hw = std::thread::hardware_concurrency();
+  auto const nt = n ? n : (hw ? hw : 1);
+
+  // the calling thread of parallel_for() has a deque of its own, the last.
+  for (unsigned int i = 0; i <= nt; i++)
+    queues_.push_back(std::make_unique<queue>());
+  for (unsigned int i = 0; i < nt; i++)
+    threads_.emplace_back([this, i] { work(i); });
+}
+
+inline thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &t : threads_)
+    t.join();
+}
+
+inline auto thread_pool::take(std::size_t const &self, task &t) -> bool {
+  auto const nq = queues_.size();
+
+  // own deque from the front, the others from the back.
+  for (std::size_t k = 0; k < nq; k++) {
+    auto &q = *queues_[(self + k) % nq];
+    std::lock_guard<std::mutex> lock(q.m);
+    if (q.q.empty())
+      continue;
+    if (0 == k) {
+      t = q.q.front();
+      q.q.pop_front();
+    } else {
+      t = q.q.back();
+      q.q.pop_back();
+    }
+    queued_--;
+    return true;
+  }
+  return false;
+}
+
+inline auto thread_pool::finish(task const &t) -> void {
+  auto &j = *t.j;
+  j.run(j.fn, t.i);
+
+  // the caller may return, and release j, as soon as it sees the count drop,
+  // so the count only drops under the lock it waits on.
+  std::lock_guard<std::mutex> lock(j.m);
+  if (1 == j.left.fetch_sub(1))
+    j.cv.notify_all();
+}
+
+inline auto thread_pool::work(std::size_t const &self) -> void {
+  for (;;) {
+    task t;
+    if (take(self, t)) {
+      finish(t);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_);
+    cv_.wait(lock, [this] { return stop_ || 0 != queued_; });
+    if (stop_)
+      return;
+  }
+}
+
+template <class fnT>
+inline auto thread_pool::parallel_for(std::size_t const &n, fnT const &f) -> void {
+  if (0 == n)
+    return;
+
+  job j;
+  j.run  = [](void const *fn, std::size_t const &i) { (*static_cast<fnT const*>(fn))(i); };
+  j.fn   = &f;
+  j.left = n;
+
+  {
+    std::lock_guard<std::mutex> lock(m_);
+    queued_ += n;
+  }
+
+  // deal [0, n) out in contiguous runs, the last to the calling thread.
+  auto const nq   = queues_.size();
+  auto const self = nq - 1;
+  for (std::size_t w = 0; w < nq; w++) {
+    auto const lo = n * w / nq;
+    auto const hi = n * (w + 1) / nq;
+    if (lo == hi)
+      continue;
+
+    auto &q = *queues_[w];
+    std::lock_guard<std::mutex> lock(q.m);
+    for (auto i = lo; i < hi; i++)
+      q.q.push_back({ &j, i });
+  }
+  cv_.notify_all();
+
+  for (task t; 0 != j.left && take(self, t);)
+    finish(t);
+
+  std::unique_lock<std::mutex> lock(j.m);
+  j.cv.wait(lock, [&j] { return 0 == j.left; });
+}
+
+} // inline namespace COMP_CORE_ISA_NAMESPACE
+} // namespace core
+} // namespace comp
+
+#endif // COMP_CORE_THREAD_POOL_H
@@ -35,6 +35,8 @@ using symb = std::uint32_t;
 //------------------------------------------------------------------------------
 #if defined(__AVX512F__)
 # include "core/simd/avx.h"
+#elif defined(__AVX2__)
+# include "core/simd/avx2.h"
 #endif
 
 //------------------------------------------------------------------------------